@@ -1,3 +1,5 @@
+#include<cstdint>
+#include<cstdio>
 #include<iostream>
 #include<map>
 #include<set>
@@ -13,6 +15,7 @@ using namespace std;
 
 //#define PROFILE_CSV
 //#define PROFILE_IBOUND_CSV
+//#define PROFILE_STREAM
 
 uint64_t refT = 0;
 
@@ -135,6 +138,17 @@ void rtTmpAccess(uint64_t addr, uint64_t ref_id, uint64_t array_id, vector<int>
         cout << DS << ",";
         cout << ri << "\n";
 #endif
+
+#ifdef PROFILE_STREAM
+        /* binary record on stdout, read from a pipe by the synthesizer:
+           uint32 source reference ID, uint32 depth, int32 source iteration vector[depth], uint64 reuse interval */
+        uint32_t stream_ref = srcRef[addr];
+        uint32_t stream_depth = srcIter[addr].size();
+        fwrite(&stream_ref, sizeof(stream_ref), 1, stdout);
+        fwrite(&stream_depth, sizeof(stream_depth), 1, stdout);
+        fwrite(srcIter[addr].data(), sizeof(int), stream_depth, stdout);
+        fwrite(&ri, sizeof(ri), 1, stdout);
+#endif
 	}
     
 	lat[addr] = refT;
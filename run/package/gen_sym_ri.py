@@ -22,6 +22,8 @@ intOpsForTerm = " -INTOPSTERM VAR NUM PLUS TIMES MINUS"
 searchTimeForTermsInSeconds = " -SEARCHTIMEFORTERMSINSECONDS 20"
 searchTimeForPredsInSeconds = " -SEARCHTIMEFORPREDSINSECONDS 40"
 rulesToApply = " -RULESTOAPPLY SrcOnly"
+# outcomes of earlier sweeps, kept outside result_path so that clearSymRI keeps them
+resultCache = " -RESULTCACHE ../data/sym_ri_cache.log"
 
 # clear all generated sym RI
 def clearSymRI(bench):
@@ -31,7 +33,7 @@ def clearSymRI(bench):
 # process each input-output file
 def processIOEFile(example):
     [folder, bench, f] = example
-    cmd_option = constantsForPredicate + constantsForTerm + intOpsForTerm + searchTimeForTermsInSeconds + searchTimeForPredsInSeconds
+    cmd_option = constantsForPredicate + constantsForTerm + intOpsForTerm + searchTimeForTermsInSeconds + searchTimeForPredsInSeconds + resultCache
         
     global rulesToApply
     if (f[0] == "src_snk_plus"):
@@ -77,9 +77,21 @@ bottomUpSearch::bottomUpSearch(int depth_bound,
         }
     }
     
+    /* language configuration decides which programs can be grown, not the input-output examples */
+    string language_key = std::to_string(depth_bound) + (isPred ? " pred" : " term");
+    for (auto op : int_ops) language_key += " " + op;
+    for (auto op : bool_ops) language_key += " " + op;
+    for (auto v : _vars) language_key += " " + v;
+    for (auto c : constants) language_key += " " + c;
+    for (auto rule : rules_to_apply) language_key += " " + rule;
+    language_key += " " + bench_name + " " + std::to_string(ref_id) + " " + std::to_string(num_growing_speed) + " " + std::to_string(num_growing_upperbound);
+    _language_key = language_key;
+    _bank = programBank::get_bank(language_key);
+    _arena = new programArena(_arena_capacity);
+    
     int var_order = 1;
     for(auto var_str : _vars) {
-        Var* var = new Var(var_str);
+        Var* var = _bank->get_var(var_str);
         BaseType* var_base = dynamic_cast<BaseType*>(var);
         if(var_base == nullptr) throw runtime_error("Init Var list error");
         _program_list.push_back(var_base);
@@ -90,16 +102,14 @@ bottomUpSearch::bottomUpSearch(int depth_bound,
     
     for (auto num_str : constants) {
         if (stoi(num_str) > num_growing_upperbound) continue;
-        Num* num = new Num(stoi(num_str));
+        Num* num = _bank->get_num(stoi(num_str));
         BaseType* num_base = dynamic_cast<BaseType*>(num);
         if (num_base == nullptr) throw runtime_error("Init Num list error");
-        num_base->set_generation(1);
         _program_list.push_back(num_base);
     }
     
     for (auto program : _program_list) {
         if (program == nullptr) throw runtime_error("Nullptr in program list");
-        program->set_generation(1);
     }
     
     for (auto ioe : input_outputs) {
@@ -114,6 +124,38 @@ bottomUpSearch::bottomUpSearch(int depth_bound,
     _num_growing_upperbound = num_growing_upperbound;
 }
 
+bottomUpSearch::~bottomUpSearch() {
+    delete _arena;
+}
+
+void bottomUpSearch::set_search_control(shared_ptr<searchControl> search_control) {
+    _search_control = search_control;
+}
+
+void bottomUpSearch::set_track_partial(bool track_partial) {
+    _track_partial = track_partial;
+}
+
+BaseType* bottomUpSearch::get_partial_program() {
+    return _partial_program;
+}
+
+int bottomUpSearch::get_partial_coverage() {
+    return _partial_coverage;
+}
+
+void bottomUpSearch::move_programs_to(programArena* arena) {
+    arena->adopt(_arena);
+    arena->keep_bank(_bank);
+}
+
+inline bool bottomUpSearch::is_stopped() {
+    if (_is_out_of_memory) return true;
+    if (_search_control != nullptr && _search_control->is_stopped()) return true;
+    if (_step_deadline != chrono::steady_clock::time_point::max() && chrono::steady_clock::now() >= _step_deadline) return true;
+    return false;
+}
+
 /******************************************
     Dump Program list
 */
@@ -1192,6 +1234,38 @@ inline BaseType* bottomUpSearch::grow_one_expr(BaseType* operand_a, BaseType* op
     return nullptr;
 }
 
+inline BaseType* bottomUpSearch::grow_one_expr_from_bank(BaseType* operand_a, BaseType* operand_b, BaseType* operand_c, string op, int program_generation) {
+    // cheap rules first, only pairs of the right generation are worth remembering
+    if (op == "F" || !generation_rule(operand_a, operand_b, operand_c, op, program_generation)) {
+        return nullptr;
+    }
+    
+    BaseType* program = nullptr;
+    if (!_bank->lookup(op, operand_a, operand_b, operand_c, program_generation, &program)) {
+        program = grow_one_expr(operand_a, operand_b, operand_c, op, program_generation);
+        if (program && !dynamic_cast<Num*>(program)) {
+            program->set_generation(program_generation);
+        }
+        BaseType* kept_program = _bank->record(op, operand_a, operand_b, operand_c, program_generation, program);
+        
+        // bank is full, this search owns the program
+        if (kept_program == nullptr && program != nullptr) {
+            if (!_arena->add(program)) {
+                delete program;
+                _is_out_of_memory = true;
+                return nullptr;
+            }
+        } else {
+            program = kept_program;
+        }
+    }
+    
+    if (program != nullptr) {
+        _grow_records[program] = {op, operand_a, operand_b, operand_c, program_generation};
+    }
+    return program;
+}
+
 void bottomUpSearch::grow(int program_generation) {
     
     int program_list_length = _program_list.size();
@@ -1200,8 +1274,9 @@ void bottomUpSearch::grow(int program_generation) {
         if (op == "PLUS" || op == "TIMES" || op == "MINUS" || op == "LEFTSHIFT" || op == "RIGHTSHIFT") {
             int cnt = 0;
             for (int i = 0; i < program_list_length; i++) {
+                if (is_stopped()) return;
                 for (int j = 0; j < program_list_length; j++) {
-                    BaseType* new_expr = grow_one_expr(_program_list[i], _program_list[j], nullptr, op, program_generation);
+                    BaseType* new_expr = grow_one_expr_from_bank(_program_list[i], _program_list[j], nullptr, op, program_generation);
                     if (new_expr != nullptr) _program_list.push_back(new_expr);
                 }
             }
@@ -1209,8 +1284,9 @@ void bottomUpSearch::grow(int program_generation) {
         else if (op == "ITE") {
             for (int i = 0; i < program_list_length; i++) {
                 for (int j = 0; j < program_list_length; j++) {
+                    if (is_stopped()) return;
                     for (int k = 0; k < program_list_length; k++) {
-                        BaseType* new_expr = grow_one_expr(_program_list[i], _program_list[j], _program_list[k], op, program_generation);
+                        BaseType* new_expr = grow_one_expr_from_bank(_program_list[i], _program_list[j], _program_list[k], op, program_generation);
                         if (new_expr != nullptr) _program_list.push_back(new_expr);
                     }
                 }
@@ -1224,21 +1300,22 @@ void bottomUpSearch::grow(int program_generation) {
     for (auto op : _bool_ops) {
         
         if (op == "F") {
-            BaseType* new_expr = grow_one_expr(nullptr, nullptr, nullptr, op, program_generation);
+            BaseType* new_expr = grow_one_expr_from_bank(nullptr, nullptr, nullptr, op, program_generation);
             if (new_expr != nullptr)
                 _program_list.push_back(new_expr);
         }
         else if (op == "NOT") {
             for (int i = 0; i < program_list_length; i++) {
-                BaseType* new_expr = grow_one_expr(_program_list[i], nullptr, nullptr, op, program_generation);
+                BaseType* new_expr = grow_one_expr_from_bank(_program_list[i], nullptr, nullptr, op, program_generation);
                 if (new_expr != nullptr)
                     _program_list.push_back(new_expr);
             }
         }
         else if (op == "AND" || op == "LT") {
             for (int i = 0; i < program_list_length; i++) {
+                if (is_stopped()) return;
                 for (int j = 0; j < program_list_length; j++) {
-                    BaseType* new_expr = grow_one_expr(_program_list[i], _program_list[j], nullptr, op, program_generation);
+                    BaseType* new_expr = grow_one_expr_from_bank(_program_list[i], _program_list[j], nullptr, op, program_generation);
                     if (new_expr != nullptr)
                         _program_list.push_back(new_expr);
                 }
@@ -1250,11 +1327,6 @@ void bottomUpSearch::grow(int program_generation) {
             
     }
     
-    for (int i = program_list_length; i < _program_list.size(); i++) {
-        if (_program_list[i] && !dynamic_cast<Num*>(_program_list[i]))
-            _program_list[i]->set_generation(program_generation);
-    }
-    
     return;
 }
 
@@ -1469,6 +1541,7 @@ void bottomUpSearch::eliminate_equivalents() {
     vector<bool> eqFlag(_program_list.size() ,false);
     
     for (int i = 0; i < _program_list.size(); i++) {
+        if (is_stopped()) return;
         if (eqFlag[i] == true) {
             continue;
         }
@@ -1523,6 +1596,7 @@ void bottomUpSearch::eliminate_program_by_value() {
     vector<bool> keep_flag(number_of_programs, true);
     
     for (int i = 0; i < number_of_programs; i++) {
+        if (is_stopped()) return;
         BaseType* program = _program_list[i];
         if (auto int_program = dynamic_cast<IntType*>(program)) {
             for (auto ioe : _input_outputs) {
@@ -1595,16 +1669,36 @@ bool bottomUpSearch::is_correct(BaseType* program) {
     return true;
 }
 
-inline string bottomUpSearch::get_correct(int program_generation) {
+int bottomUpSearch::count_covered(BaseType* program) {
+    int covered = 0;
+    if (dynamic_cast<IntType*>(program)) {
+        for (int i = 0; i < _input_outputs.size(); i++) {
+            if (evaluate_int_program(program, i) == _input_outputs[i]["_out"]) {
+                covered++;
+            }
+        }
+    }
+    return covered;
+}
+
+inline BaseType* bottomUpSearch::get_correct(int program_generation) {
     for (auto program : _program_list) {
+        if (is_stopped()) return nullptr;
+        if (_track_partial && !_is_predicate && program->get_generation() == program_generation) {
+            int covered = count_covered(program);
+            if (covered > _partial_coverage) {
+                _partial_program = program;
+                _partial_coverage = covered;
+            }
+        }
         if (program->get_generation() == program_generation && is_correct(program)) {
 #ifdef DEBUG
             cout << "SynProg: " << dump_program(program) << endl;
 #endif
-            return dump_program(program);
+            return program;
         }
     }
-    return "";
+    return nullptr;
 }
 
 bool bottomUpSearch::has_new_program(int program_generation) {
@@ -1616,40 +1710,317 @@ bool bottomUpSearch::has_new_program(int program_generation) {
 }
 
 string bottomUpSearch::search() {
+    BaseType* program = search_program();
+    if (program == nullptr) {
+        return "";
+    }
+    return dump_program(program);
+}
 
-#ifdef DEBUG
-    cout << "Init program_list size " << _program_list.size() << ", check correct" << endl;
-#endif
-    
-    //eliminate_equivalents();
-    //dump_program_list();
+BaseType* bottomUpSearch::search_program() {
+    return run_until(chrono::steady_clock::time_point::max());
+}
+
+/******************************************
+    Multi-target search
+ */
+vector<BaseType*> bottomUpSearch::search_programs_for_targets(const vector<vector<int>>& targets) {
+    vector<BaseType*> programs(targets.size(), nullptr);
+    unordered_map<vector<int>, vector<int>, output_vector_hash_t> pending_targets;
+    for (int target = 0; target < targets.size(); target++) {
+        if (targets[target].size() != _input_outputs.size()) {
+            throw runtime_error("bottomUpSearch::search_programs_for_targets(): target over other examples");
+        }
+        pending_targets[targets[target]].push_back(target);
+    }
     
+    auto search_start = chrono::steady_clock::now();
     int program_generation = 1;
-    while (get_correct(program_generation) == "") {
+    while (!pending_targets.empty()) {
+        /* one evaluation and one lookup per new program, whatever the number of targets */
+        for (auto program : _program_list) {
+            if (is_stopped()) return programs;
+            if (program->get_generation() != program_generation || !dynamic_cast<IntType*>(program)) continue;
+            vector<int> values(_input_outputs.size());
+            for (int i = 0; i < _input_outputs.size(); i++) {
+                values[i] = evaluate_int_program(program, i);
+            }
+            auto it = pending_targets.find(values);
+            if (it == pending_targets.end()) continue;
 #ifdef DEBUG
-        cout << "Current generation " << program_generation << endl;
-        cout << "Current program_list size " << _program_list.size() << ", grow" << endl;
+            cout << "SynProg: " << dump_program(program) << " for " << it->second.size() << " targets" << endl;
 #endif
-        //dump_program_list();
+            for (auto target : it->second) programs[target] = program;
+            pending_targets.erase(it);
+        }
+        /* every program is looked up once, its values are not needed again */
+        _int_program_to_value_record.clear();
+        if (pending_targets.empty()) break;
+        
         program_generation++;
+        auto start = chrono::steady_clock::now();
         grow(program_generation);
-        //dump_program_list();
+        _profile.grow_seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        start = chrono::steady_clock::now();
+        eliminate_program_by_value();
+        _profile.eliminate_seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        _profile.record_bank_size(_is_predicate, program_generation, _program_list.size());
+        if (is_stopped() || !has_new_program(program_generation)) break;
+    }
+    _profile.term_search_seconds += chrono::duration<double>(chrono::steady_clock::now() - search_start).count();
+    
+    return programs;
+}
+
+/******************************************
+    Resumable search
+ */
+bool bottomUpSearch::step() {
+    if (_phase == CHECK_CORRECT) {
+#ifdef DEBUG
+        cout << "Current program_list size " << _program_list.size() << ", check correct" << endl;
+#endif
+        _profile.record_bank_size(_is_predicate, _search_generation, _program_list.size());
+        auto start = chrono::steady_clock::now();
+        BaseType* program = get_correct(_search_generation);
+        _profile.evaluate_seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (is_stopped()) return false;
+        if (program != nullptr) {
+            _searched_program = program;
+            _phase = SEARCH_DONE;
+        } else {
+            _phase = GROW;
+        }
+    }
+    else if (_phase == GROW) {
+#ifdef DEBUG
+        cout << "Current generation " << _search_generation << endl;
+        cout << "Current program_list size " << _program_list.size() << ", grow" << endl;
+#endif
+        /* grown programs stay in the bank, so redoing an interrupted generation is cheap */
+        int program_list_length = _program_list.size();
+        auto start = chrono::steady_clock::now();
+        grow(_search_generation + 1);
+        _profile.grow_seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (is_stopped()) {
+            _program_list.resize(program_list_length);
+            return false;
+        }
+        _search_generation++;
+        _phase = ELIMINATE;
+    }
+    else if (_phase == ELIMINATE) {
 #ifdef DEBUG
         cout << "Current program_list size " << _program_list.size() << ", eliminate equvalents" << endl;
 #endif
-        
+        /* eliminations only replace the program list once they are complete */
+        auto start = chrono::steady_clock::now();
         if (!_is_predicate) eliminate_program_by_value();
         if (_is_predicate) eliminate_equivalents();
+        _profile.eliminate_seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (is_stopped()) return false;
+        _profile.record_bank_size(_is_predicate, _search_generation, _program_list.size());
+        _phase = has_new_program(_search_generation) ? CHECK_CORRECT : SEARCH_DONE;
+    }
+    return _phase == SEARCH_DONE;
+}
+
+BaseType* bottomUpSearch::run_until(chrono::steady_clock::time_point deadline) {
+    auto start = chrono::steady_clock::now();
+    _step_deadline = deadline;
+    while (_phase != SEARCH_DONE && !is_stopped()) {
+        step();
+    }
+    _step_deadline = chrono::steady_clock::time_point::max();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    _spent_seconds += seconds;
+    (_is_predicate ? _profile.predicate_search_seconds : _profile.term_search_seconds) += seconds;
+    return _searched_program;
+}
+
+bool bottomUpSearch::is_finished() {
+    return _phase == SEARCH_DONE;
+}
+
+double bottomUpSearch::get_spent_seconds() {
+    return _spent_seconds;
+}
+
+search_profile_t bottomUpSearch::take_profile() {
+    search_profile_t profile = _profile;
+    _profile = search_profile_t();
+    return profile;
+}
+
+/******************************************
+    Checkpoint
+ */
+void bottomUpSearch::save_checkpoint(ostream& out) {
+    /* number the programs reachable from the search state, operands before the programs grown from them */
+    unordered_map<BaseType*, int> program_ids;
+    vector<string> program_lines;
+    function<int(BaseType*)> number_program = [&](BaseType* program) -> int {
+        if (program == nullptr) return -1;
+        auto it = program_ids.find(program);
+        if (it != program_ids.end()) return it->second;
         
+        string line;
+        auto record = _grow_records.find(program);
+        if (record != _grow_records.end()) {
+            int operand_a = number_program(record->second.operand_a);
+            int operand_b = number_program(record->second.operand_b);
+            int operand_c = number_program(record->second.operand_c);
+            line = record->second.op + " " + std::to_string(record->second.generation) + " " +
+                   std::to_string(operand_a) + " " + std::to_string(operand_b) + " " + std::to_string(operand_c);
+        }
+        else if (dynamic_cast<Var*>(program)) {
+            line = "VAR " + program->to_string();
+        }
+        else if (auto num = dynamic_cast<Num*>(program)) {
+            line = "NUM " + std::to_string(num->interpret());
+        }
+        else {
+            throw runtime_error("bottomUpSearch::save_checkpoint(): program of unknown origin " + program->to_string());
+        }
+        program_ids[program] = program_lines.size();
+        program_lines.push_back(line);
+        return program_lines.size() - 1;
+    };
+    
+    vector<int> list_ids;
+    for (auto program : _program_list) list_ids.push_back(number_program(program));
+    int partial_id = number_program(_partial_program);
+    int searched_id = number_program(_searched_program);
+    
+    out << "bottomUpSearch checkpoint" << endl;
+    out << "language " << _language_key << endl;
+    out << "state " << _phase << " " << _search_generation << " " << _spent_seconds << " " << _partial_coverage << " " << partial_id << " " << searched_id << endl;
+    out << "programs " << program_lines.size() << endl;
+    for (auto line : program_lines) out << line << endl;
+    out << "list " << list_ids.size();
+    for (auto id : list_ids) out << " " << id;
+    out << endl;
+}
+
+void bottomUpSearch::load_checkpoint(istream& in) {
+    string line;
+    if (!getline(in, line) || line != "bottomUpSearch checkpoint") {
+        throw runtime_error("bottomUpSearch::load_checkpoint(): not a search checkpoint");
+    }
+    if (!getline(in, line) || line != "language " + _language_key) {
+        throw runtime_error("bottomUpSearch::load_checkpoint(): checkpoint of another language configuration");
+    }
+    
+    /* the search is only touched once the whole checkpoint is read */
+    int phase, search_generation, partial_coverage, partial_id, searched_id;
+    double spent_seconds;
+    string tag;
+    getline(in, line);
+    istringstream state(line);
+    if (!(state >> tag >> phase >> search_generation >> spent_seconds >> partial_coverage >> partial_id >> searched_id) || tag != "state") {
+        throw runtime_error("bottomUpSearch::load_checkpoint(): malformed state");
+    }
+    
+    /* grow the programs again through the bank, operands come first */
+    int num_of_programs;
+    getline(in, line);
+    istringstream header(line);
+    if (!(header >> tag >> num_of_programs) || tag != "programs") {
+        throw runtime_error("bottomUpSearch::load_checkpoint(): malformed program table");
+    }
+    vector<BaseType*> programs;
+    auto get_operand = [&](int id) -> BaseType* {
+        if (id < -1 || id >= (int)programs.size()) throw runtime_error("bottomUpSearch::load_checkpoint(): operand out of range");
+        return (id == -1) ? nullptr : programs[id];
+    };
+    for (int i = 0; i < num_of_programs; i++) {
+        getline(in, line);
+        istringstream program_line(line);
+        string op;
+        program_line >> op;
+        BaseType* program = nullptr;
+        if (op == "VAR") {
+            string name;
+            program_line >> name;
+            program = _bank->get_var(name);
+        }
+        else if (op == "NUM") {
+            int value;
+            program_line >> value;
+            program = _bank->get_num(value);
+        }
+        else {
+            int generation, operand_a, operand_b, operand_c;
+            if (!(program_line >> generation >> operand_a >> operand_b >> operand_c)) {
+                throw runtime_error("bottomUpSearch::load_checkpoint(): malformed program " + line);
+            }
+            program = grow_one_expr_from_bank(get_operand(operand_a), get_operand(operand_b), get_operand(operand_c), op, generation);
+        }
+        if (program == nullptr) throw runtime_error("bottomUpSearch::load_checkpoint(): can not grow " + line + " again");
+        programs.push_back(program);
+    }
+    
+    int list_length;
+    getline(in, line);
+    istringstream list(line);
+    if (!(list >> tag >> list_length) || tag != "list") {
+        throw runtime_error("bottomUpSearch::load_checkpoint(): malformed program list");
+    }
+    vector<BaseType*> program_list;
+    for (int i = 0; i < list_length; i++) {
+        int id;
+        if (!(list >> id)) throw runtime_error("bottomUpSearch::load_checkpoint(): malformed program list");
+        program_list.push_back(get_operand(id));
+    }
+    
+    _program_list = program_list;
+    _phase = (search_phase_t)phase;
+    _search_generation = search_generation;
+    _spent_seconds = spent_seconds;
+    _partial_coverage = partial_coverage;
+    _partial_program = get_operand(partial_id);
+    _searched_program = get_operand(searched_id);
+}
+
+vector<BaseType*> bottomUpSearch::enumerate(int generation_bound) {
+    auto enumerate_start = chrono::steady_clock::now();
+    while (!_enumeration_exhausted && _enumerated_generation < generation_bound) {
+        _enumerated_generation++;
+        auto start = chrono::steady_clock::now();
+        grow(_enumerated_generation);
+        _profile.grow_seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        start = chrono::steady_clock::now();
+        eliminate_equivalents();
+        _profile.eliminate_seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        _profile.record_bank_size(_is_predicate, _enumerated_generation, _program_list.size());
+        
+        if (is_stopped()) {
+            _enumeration_exhausted = true;
+            break;
+        }
+        if (!has_new_program(_enumerated_generation)) {
+            _enumeration_exhausted = true;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - enumerate_start).count();
+    (_is_predicate ? _profile.predicate_search_seconds : _profile.term_search_seconds) += seconds;
+    
+    return _program_list;
+}
+
+bool bottomUpSearch::has_more_programs() {
+    return !_enumeration_exhausted;
+}
+
+void bottomUpSearch::warm_up_bank(int generation_bound) {
+    vector<BaseType*> leaves = _program_list;
+    
+    for (int program_generation = 2; program_generation <= generation_bound; program_generation++) {
+        grow(program_generation);
         if (!has_new_program(program_generation)) {
             break;
         }
-        
-        //if (!_is_predicate) dump_program_list();
-#ifdef DEBUG
-        cout << "Current program_list size " << _program_list.size() << ", check correct" << endl;
-#endif
     }
     
-    return get_correct(program_generation);
+    _program_list = leaves;
 }
@@ -2,18 +2,48 @@
 #define BOTTOMUPSEARCH_H
 
 #include "langDef.hpp"
+#include "programBank.hpp"
+#include "searchControl.hpp"
 #include "typeDef.hpp"
 #include <algorithm>
 #include <numeric>
+#include <functional>
 #include <future>
 #include <chrono>
 #include <thread>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <unordered_map>
 #include <vector>
 
 using namespace std;
 
 //#define DEBUG
 
+/* How a program was grown, enough to grow it again when a checkpoint is restored */
+struct grow_record_t {
+    string op;
+    BaseType* operand_a;
+    BaseType* operand_b;
+    BaseType* operand_c;
+    int generation;
+};
+
+/* Output vector of a target over the examples, for multi-target search */
+struct output_vector_hash_t {
+    size_t operator()(const vector<int>& outputs) const {
+        size_t h = outputs.size();
+        for (auto output : outputs) {
+            h ^= hash<int>()(output) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+};
+
+/* Phase a resumable search continues from */
+enum search_phase_t { CHECK_CORRECT, GROW, ELIMINATE, SEARCH_DONE };
+
 class bottomUpSearch {
 public:
     bottomUpSearch(int depth_bound,
@@ -29,12 +59,52 @@ public:
                    int num_growing_upperbound,
                    input_outputs_t input_outputs);
     
+    ~bottomUpSearch();
+    
     /* search function */
     string search();
+    BaseType* search_program();
+    
+    /* multi-target search: every new term is looked up among the output vectors of the targets,
+       the example outputs only bound the values of the programs kept, nullptr for targets not found */
+    vector<BaseType*> search_programs_for_targets(const vector<vector<int>>& targets);
+    
+    /* resumable search: every step checks, grows or eliminates one generation,
+       a step interrupted by the deadline or a cancellation is rolled back and redone by the next one */
+    bool step();
+    BaseType* run_until(chrono::steady_clock::time_point deadline);
+    bool is_finished();
+    double get_spent_seconds();
+    
+    /* time spent per phase and program list sizes since the last call */
+    search_profile_t take_profile();
+    
+    /* save the search state (program list, generation, phase) and restore it into a fresh search of the same language */
+    void save_checkpoint(ostream& out);
+    void load_checkpoint(istream& in);
+    
+    /* cooperative deadline and cancellation, checked inside grow and eliminate */
+    void set_search_control(shared_ptr<searchControl> search_control);
+    
+    /* hand the programs this search allocated outside the program bank to a longer-lived arena */
+    void move_programs_to(programArena* arena);
+    
+    /* anytime mode: remember the term correct on the most examples while searching */
+    void set_track_partial(bool track_partial);
+    BaseType* get_partial_program();
+    int get_partial_coverage();
+    
+    /* enumerate programs up to a generation bound without checking correctness,
+       successive calls continue from the last enumerated generation */
+    vector<BaseType*> enumerate(int generation_bound);
+    bool has_more_programs();
+    
+    /* grow programs without elimination to fill the shared program bank */
+    void warm_up_bank(int generation_bound);
     
     /* dump language used */
     void dump_language_defination();
-    
+
 private:
     /* dump one program */
     inline string dump_program(BaseType* program);
@@ -49,7 +119,13 @@ private:
     void eliminate_program_by_value();
     
     /* Check whether there is a correct program in program list */
-    inline string get_correct(int program_generation);
+    inline BaseType* get_correct(int program_generation);
+    
+    /* Number of examples a term is correct on */
+    int count_covered(BaseType* program);
+    
+    /* Check whether the search ran out of time, was cancelled or ran out of memory */
+    inline bool is_stopped();
     
     /* Dumping function */
     void dump_program_list();
@@ -67,6 +143,34 @@ private:
     
     /* Construct one expression: op i j */
     BaseType* grow_one_expr(BaseType* operand_a, BaseType* operand_b, BaseType* operand_c, string op, int program_generation);
+    inline BaseType* grow_one_expr_from_bank(BaseType* operand_a, BaseType* operand_b, BaseType* operand_c, string op, int program_generation);
+    
+    /* Enumeration cache shared with other searches of the same language */
+    string _language_key;
+    shared_ptr<programBank> _bank;
+    
+    /* Provenance of the grown programs, for checkpoints */
+    unordered_map<BaseType*, grow_record_t> _grow_records;
+    
+    /* Programs allocated by this search only, bounded */
+    programArena* _arena;
+    size_t _arena_capacity = 1 << 21;
+    bool _is_out_of_memory = false;
+    
+    shared_ptr<searchControl> _search_control;
+    
+    /* Resumable search state */
+    search_phase_t _phase = CHECK_CORRECT;
+    int _search_generation = 1;
+    BaseType* _searched_program = nullptr;
+    chrono::steady_clock::time_point _step_deadline = chrono::steady_clock::time_point::max();
+    double _spent_seconds = 0;
+    search_profile_t _profile;
+    
+    /* Best partial term, in anytime mode */
+    bool _track_partial = false;
+    BaseType* _partial_program = nullptr;
+    int _partial_coverage = 0;
     
     /* Temporal program evaluation result record */
     map<pair<BaseType*, int>, int> _int_program_to_value_record;
@@ -87,11 +191,13 @@ private:
     
     /* Program list */
     vector<BaseType*> _program_list;
+    int _enumerated_generation = 1;
+    bool _enumeration_exhausted = false;
     
     /* Input-output examples */
     input_outputs_t _input_outputs;
     int _max_output = 0;
-
+    
     /* Language defination */
     int _depth_bound;
     vector<string> _int_ops;
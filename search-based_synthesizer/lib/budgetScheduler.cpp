@@ -0,0 +1,86 @@
+#include "budgetScheduler.hpp"
+/******************************************
+    Constructor
+ */
+budgetScheduler::budgetScheduler(string history_file, string bench_name, int term_budget_cap, int predicate_budget_cap) {
+    _history_file = history_file;
+    _bench_name = bench_name;
+    _term_budget_cap = term_budget_cap;
+    _predicate_budget_cap = predicate_budget_cap;
+    
+    /* history lines: bench phase seconds */
+    vector<double> term_solve_times;
+    vector<double> predicate_solve_times;
+    ifstream in(history_file);
+    string line;
+    while (getline(in, line)) {
+        istringstream history_line(line);
+        string bench, phase;
+        double seconds;
+        if (!(history_line >> bench >> phase >> seconds)) continue;
+        if (bench != bench_name) continue;
+        if (phase == "term") term_solve_times.push_back(seconds);
+        if (phase == "pred") predicate_solve_times.push_back(seconds);
+    }
+    
+    _term_unit_budget = min(unit_budget_from(term_solve_times), _term_budget_cap);
+    _predicate_unit_budget = min(unit_budget_from(predicate_solve_times), _predicate_budget_cap);
+}
+
+int budgetScheduler::unit_budget_from(vector<double> solve_times) {
+    if (solve_times.size() < _min_num_of_samples) return 1;
+    sort(solve_times.begin(), solve_times.end());
+    double seconds = solve_times[(int)(_unit_quantile * (solve_times.size() - 1))];
+    return max(1, (int)ceil(seconds));
+}
+
+/******************************************
+    Rounds
+ */
+/* 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ... */
+int budgetScheduler::luby(int i) {
+    int k = 1;
+    while ((1 << k) - 1 < i) k++;
+    if (i == (1 << k) - 1) return 1 << (k - 1);
+    return luby(i - (1 << (k - 1)) + 1);
+}
+
+bool budgetScheduler::next_round(int* term_budget, int* predicate_budget, int* num_of_repeats) {
+    if (_is_capped_round_run) return false;
+    
+    _round++;
+    *term_budget = min(_term_unit_budget * luby(_round), _term_budget_cap);
+    *predicate_budget = min(_predicate_unit_budget * luby(_round), _predicate_budget_cap);
+    *num_of_repeats = count(_budgets_run.begin(), _budgets_run.end(), make_pair(*term_budget, *predicate_budget));
+    _budgets_run.push_back(make_pair(*term_budget, *predicate_budget));
+    
+    if (*term_budget == _term_budget_cap && *predicate_budget == _predicate_budget_cap) {
+        _is_capped_round_run = true;
+    }
+    return true;
+}
+
+int budgetScheduler::get_unit_budget(bool is_predicate) {
+    return is_predicate ? _predicate_unit_budget : _term_unit_budget;
+}
+
+/******************************************
+    History
+ */
+void budgetScheduler::record(bool is_predicate, double seconds) {
+    unique_lock<mutex> lock(_mutex);
+    _solve_times.push_back(make_pair(is_predicate, seconds));
+}
+
+void budgetScheduler::save_history() {
+    /* schedulers of the files of a batch append to the same history */
+    static mutex history_mutex;
+    unique_lock<mutex> history_lock(history_mutex);
+    unique_lock<mutex> lock(_mutex);
+    ofstream out(_history_file, ios::app);
+    if (!out.is_open()) throw runtime_error("Can not write budget history " + _history_file);
+    for (auto solve_time : _solve_times) {
+        out << _bench_name << " " << (solve_time.first ? "pred" : "term") << " " << solve_time.second << endl;
+    }
+    _solve_times.clear();
+}
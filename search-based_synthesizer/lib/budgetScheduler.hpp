@@ -0,0 +1,62 @@
+#ifndef BUDGETSCHEDULER_H
+#define BUDGETSCHEDULER_H
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+ Budget scheduler: unification runs rounds of growing search budgets instead
+ of one fixed budget per phase. The unit budget of a phase comes from the
+ solve times recorded by earlier runs of the benchmark, round budgets follow
+ the Luby sequence in units and are capped by the budgets of the command line.
+ Rounds repeating a budget explore the next ranked split alternatives.
+ */
+class budgetScheduler {
+public:
+    budgetScheduler(string history_file, string bench_name, int term_budget_cap, int predicate_budget_cap);
+    
+    /* budgets of the next round and how many earlier rounds ran them, false once the capped round has run */
+    bool next_round(int* term_budget, int* predicate_budget, int* num_of_repeats);
+    
+    /* solve time of a successful search */
+    void record(bool is_predicate, double seconds);
+    
+    /* append the solve times of this run to the history file */
+    void save_history();
+    
+    int get_unit_budget(bool is_predicate);
+
+private:
+    static int luby(int i);
+    int unit_budget_from(vector<double> solve_times);
+    
+    string _history_file;
+    string _bench_name;
+    
+    int _term_budget_cap;
+    int _predicate_budget_cap;
+    int _term_unit_budget = 1;
+    int _predicate_unit_budget = 1;
+    
+    /* the unit covers this quantile of the recorded solve times, once there are enough of them */
+    double _unit_quantile = 0.9;
+    int _min_num_of_samples = 10;
+    
+    int _round = 0;
+    bool _is_capped_round_run = false;
+    vector<pair<int, int>> _budgets_run;
+    
+    /* solve times of this run */
+    vector<pair<bool, double>> _solve_times;
+    mutex _mutex;
+};
+
+#endif
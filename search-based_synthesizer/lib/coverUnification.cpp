@@ -0,0 +1,433 @@
+#include "coverUnification.hpp"
+/******************************************
+    Constructor
+ */
+coverUnification::coverUnification(int depth_bound_for_predicate,
+                                   vector<string> int_ops_in_predicate,
+                                   vector<string> vars_in_predicate,
+                                   vector<string> constants_in_predicate,
+                                   int depth_bound_for_term,
+                                   vector<string> int_ops_in_term,
+                                   vector<string> bool_ops_in_term,
+                                   vector<string> vars_in_term,
+                                   vector<string> constants_in_term,
+                                   vector<string> rules_to_apply,
+                                   string bench_name,
+                                   int ref_id,
+                                   int num_growing_speed,
+                                   int num_growing_upperbound,
+                                   input_outputs_t input_outputs,
+                                   int guard_depth_bound) {
+    _depth_bound_for_predicate = depth_bound_for_predicate;
+    _int_ops_in_predicate = int_ops_in_predicate;
+    _vars_in_predicate = vars_in_predicate;
+    _constants_in_predicate = constants_in_predicate;
+    
+    _depth_bound_for_term = depth_bound_for_term;
+    _int_ops_in_term = int_ops_in_term;
+    _bool_ops_in_term = bool_ops_in_term;
+    _vars_in_term = vars_in_term;
+    _constants_in_term = constants_in_term;
+    
+    _guard_depth_bound = guard_depth_bound;
+    
+    _example_table = new exampleTable(input_outputs);
+    _input_outputs = input_outputs;
+    _num_of_examples = _input_outputs.size();
+    _num_of_words = (_num_of_examples + 63) / 64;
+    
+    _result_arena = new programArena();
+    _start = chrono::steady_clock::now();
+    
+    _term_enumerator = new bottomUpSearch(_depth_bound_for_term,
+                                          _int_ops_in_term,
+                                          _bool_ops_in_term,
+                                          _vars_in_term,
+                                          _constants_in_term,
+                                          false,
+                                          rules_to_apply,
+                                          bench_name,
+                                          ref_id,
+                                          num_growing_speed,
+                                          num_growing_upperbound,
+                                          input_outputs);
+    
+    vector<string> bool_ops = {"LT"};
+    _atom_enumerator = new bottomUpSearch(_depth_bound_for_predicate,
+                                          _int_ops_in_predicate,
+                                          bool_ops,
+                                          _vars_in_predicate,
+                                          _constants_in_predicate,
+                                          true,
+                                          rules_to_apply,
+                                          bench_name,
+                                          ref_id,
+                                          num_growing_speed,
+                                          num_growing_upperbound,
+                                          input_outputs);
+}
+
+coverUnification::~coverUnification() {
+    delete _term_enumerator;
+    delete _atom_enumerator;
+    delete _result_arena;
+    delete _example_table;
+}
+
+/******************************************
+    Bitset helpers
+ */
+inline example_bitset_t coverUnification::make_bitset(bool value) {
+    example_bitset_t bits(_num_of_words, value ? ~uint64_t(0) : uint64_t(0));
+    if (value && _num_of_examples % 64 != 0) {
+        bits.back() = (uint64_t(1) << (_num_of_examples % 64)) - 1;
+    }
+    return bits;
+}
+
+inline int coverUnification::count(const example_bitset_t& bits) {
+    int cnt = 0;
+    for (auto word : bits) cnt += __builtin_popcountll(word);
+    return cnt;
+}
+
+inline example_bitset_t coverUnification::bit_and(const example_bitset_t& a, const example_bitset_t& b) {
+    example_bitset_t bits(_num_of_words);
+    for (int i = 0; i < _num_of_words; i++) bits[i] = a[i] & b[i];
+    return bits;
+}
+
+inline example_bitset_t coverUnification::bit_and_not(const example_bitset_t& a, const example_bitset_t& b) {
+    example_bitset_t bits(_num_of_words);
+    for (int i = 0; i < _num_of_words; i++) bits[i] = a[i] & ~b[i];
+    return bits;
+}
+
+/******************************************
+    Term cover
+ */
+bool coverUnification::extend_terms(int generation_bound) {
+    vector<BaseType*> programs = _term_enumerator->enumerate(generation_bound);
+    
+    int num_of_terms = _terms.size();
+    for (auto program : programs) {
+        if (_visited_terms.find(program) != _visited_terms.end()) continue;
+        _visited_terms.insert(program);
+        
+        auto term = dynamic_cast<IntType*>(program);
+        if (term == nullptr) continue;
+        
+        example_bitset_t cover = make_bitset(false);
+        for (int i = 0; i < _num_of_examples; i++) {
+            if (term->interpret(_input_outputs[i]) == _example_table->get_output(i)) {
+                cover[i / 64] |= (uint64_t(1) << (i % 64));
+            }
+        }
+        
+        /* terms correct on the same examples are interchangeable, keep the first and smallest */
+        if (count(cover) == 0 || _seen_covers.find(cover) != _seen_covers.end()) continue;
+        _seen_covers.insert(cover);
+        
+        _terms.push_back(term);
+        _term_covers.push_back(cover);
+    }
+
+#ifdef DEBUG
+    cout << "Term library size " << _terms.size() << " at generation " << generation_bound << endl;
+#endif
+    return _terms.size() != num_of_terms;
+}
+
+/* greedy set cover, most newly covered examples first */
+bool coverUnification::select_cover() {
+    _cover.clear();
+    example_bitset_t uncovered = make_bitset(true);
+    while (count(uncovered) != 0) {
+        int best_id = -1;
+        int best_covered = 0;
+        for (int i = 0; i < _terms.size(); i++) {
+            int covered = count(bit_and(uncovered, _term_covers[i]));
+            if (covered > best_covered) {
+                best_covered = covered;
+                best_id = i;
+            }
+        }
+        if (best_id == -1) return false;
+        _cover.push_back(best_id);
+        uncovered = bit_and_not(uncovered, _term_covers[best_id]);
+    }
+    return true;
+}
+
+int coverUnification::best_cover(const example_bitset_t& examples, int* term_id) {
+    int best_covered = -1;
+    for (auto id : _cover) {
+        int covered = count(bit_and(examples, _term_covers[id]));
+        if (covered > best_covered) {
+            best_covered = covered;
+            *term_id = id;
+        }
+    }
+    return best_covered;
+}
+
+/******************************************
+    Guards
+ */
+bool coverUnification::extend_atoms(int generation_bound) {
+    vector<BaseType*> programs = _atom_enumerator->enumerate(generation_bound);
+    
+    int num_of_atoms = _atoms.size();
+    example_bitset_t all = make_bitset(true);
+    for (auto program : programs) {
+        if (_visited_atoms.find(program) != _visited_atoms.end()) continue;
+        _visited_atoms.insert(program);
+        
+        auto lt = dynamic_cast<Lt*>(program);
+        if (lt == nullptr) continue;
+        
+        example_bitset_t bits = make_bitset(false);
+        for (int i = 0; i < _num_of_examples; i++) {
+            if (lt->interpret(_input_outputs[i])) {
+                bits[i / 64] |= (uint64_t(1) << (i % 64));
+            }
+        }
+        
+        /* an atom and its complement route the examples the same way */
+        example_bitset_t complement = bit_and_not(all, bits);
+        if (_seen_atom_bits.find(bits) != _seen_atom_bits.end() || _seen_atom_bits.find(complement) != _seen_atom_bits.end()) continue;
+        _seen_atom_bits.insert(bits);
+        
+        _atoms.push_back(lt);
+        _atom_bits.push_back(bits);
+    }
+
+#ifdef DEBUG
+    cout << "Atom library size " << _atoms.size() << " at generation " << generation_bound << endl;
+#endif
+    return _atoms.size() != num_of_atoms;
+}
+
+/* route the examples to covering terms, splitting on the atom that lets the most examples reach one */
+IntType* coverUnification::learn_guards(const example_bitset_t& examples, int depth) {
+    int term_id = -1;
+    int covered = best_cover(examples, &term_id);
+    if (covered == count(examples)) {
+        return _terms[term_id];
+    }
+    if (depth >= _guard_depth_bound || _search_control->is_stopped()) {
+        return _is_anytime ? _terms[term_id] : nullptr;
+    }
+    
+    int best_atom = -1;
+    int best_covered = covered;
+    for (int i = 0; i < _atoms.size(); i++) {
+        example_bitset_t tcase = bit_and(examples, _atom_bits[i]);
+        example_bitset_t fcase = bit_and_not(examples, _atom_bits[i]);
+        if (count(tcase) == 0 || count(fcase) == 0) continue;
+        
+        int tcase_term_id;
+        int fcase_term_id;
+        int split_covered = best_cover(tcase, &tcase_term_id) + best_cover(fcase, &fcase_term_id);
+        if (split_covered > best_covered) {
+            best_covered = split_covered;
+            best_atom = i;
+        }
+    }
+    if (best_atom == -1) {
+        return _is_anytime ? _terms[term_id] : nullptr;
+    }
+    
+    IntType* tcase = learn_guards(bit_and(examples, _atom_bits[best_atom]), depth + 1);
+    if (tcase == nullptr) return nullptr;
+    IntType* fcase = learn_guards(bit_and_not(examples, _atom_bits[best_atom]), depth + 1);
+    if (fcase == nullptr) return nullptr;
+    
+    Ite* ite = new Ite(_atoms[best_atom], tcase, fcase, true);
+    _result_arena->add(ite);
+    return ite;
+}
+
+int coverUnification::count_covered(IntType* program) {
+    int covered = 0;
+    for (int i = 0; i < _num_of_examples; i++) {
+        if (program->interpret(_input_outputs[i]) == _example_table->get_output(i)) {
+            covered++;
+        }
+    }
+    return covered;
+}
+
+/******************************************
+    Search
+ */
+BaseType* coverUnification::search_program(int search_time_for_terms_in_seconds, int search_time_for_predicates_in_seconds) {
+    /* enumerate terms until they cover every example */
+    _search_control = make_shared<searchControl>(search_time_for_terms_in_seconds, _deadline_control);
+    _term_enumerator->set_search_control(_search_control);
+    report_progress(extend_terms(_term_generation));
+    while (!select_cover() && _term_enumerator->has_more_programs()) {
+        _term_generation++;
+        report_progress(extend_terms(_term_generation));
+    }
+    if (!select_cover()) {
+#ifdef DEBUG
+        cout << "Terms do not cover the examples" << endl;
+#endif
+        /* in anytime mode the terms picked so far still make a partial program */
+        if (!_is_anytime || _cover.empty()) return nullptr;
+    }
+
+#ifdef DEBUG
+    cout << "Cover of " << _cover.size() << " terms:";
+    for (auto id : _cover) cout << " " << _terms[id]->to_string();
+    cout << endl;
+#endif
+    
+    /* learn guards, with more atoms each time they cannot route the examples */
+    _search_control = make_shared<searchControl>(search_time_for_predicates_in_seconds, _deadline_control);
+    _atom_enumerator->set_search_control(_search_control);
+    report_progress(extend_atoms(_atom_generation));
+    while (!_search_control->is_stopped()) {
+        IntType* program = learn_guards(make_bitset(true), 0);
+        int covered = (program != nullptr) ? count_covered(program) : 0;
+        if (covered == _num_of_examples) {
+            _searched_program = program;
+            return program;
+        }
+        if (covered > _num_of_covered) {
+            _partial_program = program;
+            _num_of_covered = covered;
+        }
+        if (!_atom_enumerator->has_more_programs()) break;
+        _atom_generation++;
+        report_progress(extend_atoms(_atom_generation));
+    }
+    return nullptr;
+}
+
+void coverUnification::set_anytime(int deadline_in_seconds) {
+    _is_anytime = true;
+    _deadline_control = make_shared<searchControl>(deadline_in_seconds, _deadline_control);
+}
+
+void coverUnification::set_search_control(shared_ptr<searchControl> search_control) {
+    _deadline_control = make_shared<searchControl>(search_control);
+}
+
+void coverUnification::set_progress_callback(progress_callback_t progress_callback) {
+    _progress_callback = progress_callback;
+}
+
+search_progress_t coverUnification::get_progress() {
+    _progress.elapsed_seconds = chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+    return _progress;
+}
+
+search_profile_t coverUnification::get_profile() {
+    _profile.merge(_term_enumerator->take_profile());
+    _profile.merge(_atom_enumerator->take_profile());
+    return _profile;
+}
+
+unification_shape_t coverUnification::get_tree_shape() {
+    unification_shape_t shape;
+    function<void(IntType*, int)> visit = [&](IntType* program, int depth) {
+        shape.num_of_nodes++;
+        shape.depth = max(shape.depth, depth);
+        if (auto ite = dynamic_cast<Ite*>(program)) {
+            visit(ite->get_tcase(), depth + 1);
+            visit(ite->get_fcase(), depth + 1);
+        } else {
+            shape.num_of_leaves++;
+        }
+    };
+    BaseType* program = (_searched_program != nullptr) ? _searched_program : _partial_program;
+    if (auto int_program = dynamic_cast<IntType*>(program)) visit(int_program, 0);
+    return shape;
+}
+
+void coverUnification::report_progress(bool is_found) {
+    _progress.num_of_searches++;
+    if (is_found) _progress.num_of_found++;
+    _progress.elapsed_seconds = chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+    if (_progress_callback) _progress_callback(_progress);
+}
+
+BaseType* coverUnification::get_program() {
+    return _searched_program;
+}
+
+BaseType* coverUnification::get_partial_program() {
+    return _partial_program;
+}
+
+int coverUnification::get_num_of_covered() {
+    return (_searched_program != nullptr) ? _num_of_examples : _num_of_covered;
+}
+
+void coverUnification::move_programs_to(programArena* arena) {
+    _term_enumerator->move_programs_to(arena);
+    _atom_enumerator->move_programs_to(arena);
+    arena->adopt(_result_arena);
+}
+
+string coverUnification::search(int search_time_for_terms_in_seconds, int search_time_for_predicates_in_seconds) {
+    BaseType* searched_program = search_program(search_time_for_terms_in_seconds, search_time_for_predicates_in_seconds);
+    return (searched_program != nullptr) ? searched_program->to_string() : "";
+}
+
+/******************************************
+    Dumping funcions
+ */
+void coverUnification::dump_language_defination() {
+    cout << "Language used in cover-based Unification:" << endl;
+    
+    cout << "    Guard language:" << endl;
+    cout << "        program depth bound: " << _depth_bound_for_predicate << endl;
+    cout << "        intOps: ";
+    for (const auto& op : _int_ops_in_predicate) cout << op << " ";
+    cout << endl;
+    cout << "        constants: ";
+    for (const auto& c : _constants_in_predicate) cout << c << " ";
+    cout << endl;
+    cout << "        vars: ";
+    for (const auto& v : _vars_in_predicate) cout << v << " ";
+    cout << endl;
+    cout << "        guard depth bound: " << _guard_depth_bound << endl;
+    
+    cout << "    Term language:" << endl;
+    cout << "        program depth bound: " << _depth_bound_for_term << endl;
+    cout << "        intOps: ";
+    for (const auto& op : _int_ops_in_term) cout << op << " ";
+    cout << endl;
+    cout << "        boolOps: ";
+    for (const auto& op : _bool_ops_in_term) cout << op << " ";
+    cout << endl;
+    cout << "        constants: ";
+    for (const auto& c : _constants_in_term) cout << c << " ";
+    cout << endl;
+    cout << "        vars: ";
+    for (const auto& v : _vars_in_term) cout << v << " ";
+    cout << endl;
+}
+
+void coverUnification::dump_searched_program(ostream& out) {
+    if (_searched_program != nullptr) {
+        out << "Searched Program (^0^) : " << _searched_program->to_string() << endl;
+    } else {
+        out << "Not yet found, (T^T)" << endl;
+        if (_is_anytime && _partial_program != nullptr) {
+            out << "Partial Program (^-^) : " << _partial_program->to_string() << endl;
+            out << "Coverage : " << _num_of_covered << " / " << _num_of_examples << " examples ("
+                 << fixed << setprecision(2) << 100.0 * _num_of_covered / _num_of_examples << "%)" << endl;
+        }
+    }
+}
+
+string coverUnification::get_searched_program() {
+    if (_searched_program != nullptr) {
+        return "Searched Program (^0^) : " + _searched_program->to_string();
+    }
+    return "Not yet founded, (T^T)";
+}
@@ -0,0 +1,158 @@
+#ifndef COVERUNIFICATION_H
+#define COVERUNIFICATION_H
+
+#include "bottomUpSearch.hpp"
+#include "exampleTable.hpp"
+#include "predicateLearner.hpp"
+#include "programBank.hpp"
+#include "searchControl.hpp"
+#include "typeDef.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <set>
+#include <vector>
+
+//#define DEBUG
+
+/*
+ Cover-based unification, in the style of EUSolver.
+ Terms are enumerated once over all examples, each with the bitset of the
+ examples it is correct on. A small set of terms covering every example is
+ picked greedily, then a decision tree over Lt atoms routes every example to
+ a term covering it. The tree becomes nested if-then-else programs.
+ */
+class coverUnification {
+public:
+    coverUnification(int depth_bound_for_predicate,
+                     vector<string> int_ops_in_predicate,
+                     vector<string> vars_in_predicate,
+                     vector<string> constants_in_predicate,
+                     
+                     int depth_bound_for_term,
+                     vector<string> int_ops_in_term,
+                     vector<string> bool_ops_in_term,
+                     vector<string> vars_in_term,
+                     vector<string> constants_in_term,
+                     
+                     vector<string> rules_to_apply,
+                     
+                     string bench_name,
+                     int ref_id,
+                     
+                     int num_growing_speed,
+                     int num_growing_upperbound,
+                     
+                     input_outputs_t input_outputs,
+                     
+                     int guard_depth_bound = 8);
+    ~coverUnification();
+    
+    string search(int search_time_for_terms_in_seconds, int search_time_for_predicates_in_seconds);
+    BaseType* search_program(int search_time_for_terms_in_seconds, int search_time_for_predicates_in_seconds);
+    
+    /* anytime mode: stop at the deadline and keep the program correct on the most examples */
+    void set_anytime(int deadline_in_seconds);
+    
+    /* stop the enumeration when an outer control is cancelled or out of time, set before set_anytime */
+    void set_search_control(shared_ptr<searchControl> search_control);
+    
+    /* report the progress after every enumerated generation of terms or atoms */
+    void set_progress_callback(progress_callback_t progress_callback);
+    search_progress_t get_progress();
+    
+    /* time spent per phase by the enumerations so far, and the shape of the guard tree of the searched program */
+    search_profile_t get_profile();
+    unification_shape_t get_tree_shape();
+    
+    /* searched program, or in anytime mode the best partial one and the examples it is correct on */
+    BaseType* get_program();
+    BaseType* get_partial_program();
+    int get_num_of_covered();
+    
+    /* hand the searched program and the terms and atoms it is built on to a longer-lived arena */
+    void move_programs_to(programArena* arena);
+    
+    /* Dumping fucntions */
+    void dump_language_defination();
+    void dump_searched_program(ostream& out = cout);
+    string get_searched_program();
+
+private:
+    /* Term cover */
+    bool extend_terms(int generation_bound);
+    bool select_cover();
+    
+    /* Guards */
+    bool extend_atoms(int generation_bound);
+    IntType* learn_guards(const example_bitset_t& examples, int depth);
+    int best_cover(const example_bitset_t& examples, int* term_id);
+    
+    /* count an enumerated generation and report the progress */
+    void report_progress(bool is_found);
+    
+    /* Check the assembled program on the examples */
+    int count_covered(IntType* program);
+    
+    /* Bitset helpers */
+    inline example_bitset_t make_bitset(bool value);
+    inline int count(const example_bitset_t& bits);
+    inline example_bitset_t bit_and(const example_bitset_t& a, const example_bitset_t& b);
+    inline example_bitset_t bit_and_not(const example_bitset_t& a, const example_bitset_t& b);
+    
+    /* Examples */
+    exampleTable* _example_table;
+    input_outputs_t _input_outputs;
+    int _num_of_examples;
+    int _num_of_words;
+    
+    /* Enumerated terms with the examples they are correct on, and the picked cover */
+    bottomUpSearch* _term_enumerator;
+    int _term_generation = 1;
+    set<BaseType*> _visited_terms;
+    set<example_bitset_t> _seen_covers;
+    vector<IntType*> _terms;
+    vector<example_bitset_t> _term_covers;
+    vector<int> _cover;
+    
+    /* Lt atoms the guards are built from */
+    bottomUpSearch* _atom_enumerator;
+    int _atom_generation = 1;
+    set<BaseType*> _visited_atoms;
+    set<example_bitset_t> _seen_atom_bits;
+    vector<Lt*> _atoms;
+    vector<example_bitset_t> _atom_bits;
+    
+    shared_ptr<searchControl> _search_control;
+    
+    /* owns the if-then-else nodes of the searched program */
+    programArena* _result_arena;
+    BaseType* _searched_program = nullptr;
+    
+    /* anytime mode, the deadline is also the scope of an outer control */
+    bool _is_anytime = false;
+    shared_ptr<searchControl> _deadline_control;
+    BaseType* _partial_program = nullptr;
+    int _num_of_covered = 0;
+    
+    /* progress of the enumeration since construction */
+    chrono::steady_clock::time_point _start;
+    search_progress_t _progress;
+    progress_callback_t _progress_callback;
+    search_profile_t _profile;
+    
+    /* Language definition */
+    int _depth_bound_for_predicate;
+    vector<string> _int_ops_in_predicate;
+    vector<string> _vars_in_predicate;
+    vector<string> _constants_in_predicate;
+    int _depth_bound_for_term;
+    vector<string> _int_ops_in_term;
+    vector<string> _bool_ops_in_term;
+    vector<string> _vars_in_term;
+    vector<string> _constants_in_term;
+    
+    int _guard_depth_bound;
+};
+
+#endif
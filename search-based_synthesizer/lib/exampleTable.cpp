@@ -0,0 +1,104 @@
+#include "exampleTable.hpp"
+/******************************************
+    Constructor
+ */
+exampleTable::exampleTable(input_outputs_t input_outputs) {
+    if (!input_outputs.empty()) {
+        for (auto var_value : input_outputs.front()) {
+            if (var_value.first != "_out") _vars.push_back(var_value.first);
+        }
+    }
+    _columns = vector<vector<int>>(_vars.size());
+    
+    for (auto &ioe : input_outputs) {
+        if (ioe.find("_out") == ioe.end()) throw runtime_error("No _out entry in IOE");
+        for (int column = 0; column < _vars.size(); column++) {
+            _columns[column].push_back(ioe[_vars[column]]);
+        }
+        _outputs.push_back(ioe["_out"]);
+    }
+}
+
+exampleTable::exampleTable(vector<string> vars, vector<vector<int>> columns, vector<int> outputs) {
+    if (columns.size() != vars.size()) throw runtime_error("Example table needs one column per variable");
+    for (auto var : vars) {
+        if (var == "_out") throw runtime_error("_out is the output column of the example table");
+    }
+    for (auto &column : columns) {
+        if (column.size() != outputs.size()) throw runtime_error("Example table columns differ in length");
+    }
+    _vars = vars;
+    _columns = move(columns);
+    _outputs = move(outputs);
+}
+
+/******************************************
+    Accessors
+ */
+int exampleTable::size() {
+    return _outputs.size();
+}
+
+vector<string> exampleTable::get_vars() {
+    return _vars;
+}
+
+int exampleTable::get_column(string var) {
+    auto it = find(_vars.begin(), _vars.end(), var);
+    return (it != _vars.end()) ? it - _vars.begin() : -1;
+}
+
+int exampleTable::get_value(int column, int example_id) {
+    return _columns[column][example_id];
+}
+
+int exampleTable::get_output(int example_id) {
+    return _outputs[example_id];
+}
+
+vector<int> exampleTable::get_outputs(const vector<int>& example_ids) {
+    vector<int> outputs;
+    outputs.reserve(example_ids.size());
+    for (auto id : example_ids) outputs.push_back(_outputs[id]);
+    return outputs;
+}
+
+exampleTable exampleTable::select(const vector<int>& example_ids) {
+    vector<vector<int>> columns(_vars.size());
+    for (int column = 0; column < _vars.size(); column++) {
+        columns[column].reserve(example_ids.size());
+        for (auto id : example_ids) columns[column].push_back(_columns[column][id]);
+    }
+    return exampleTable(_vars, move(columns), get_outputs(example_ids));
+}
+
+void exampleTable::get_input_output(int example_id, input_output_t* ioe) {
+    for (int column = 0; column < _vars.size(); column++) {
+        (*ioe)[_vars[column]] = _columns[column][example_id];
+    }
+    (*ioe)["_out"] = _outputs[example_id];
+}
+
+input_outputs_t exampleTable::get_input_outputs() {
+    vector<int> example_ids(_outputs.size());
+    for (int i = 0; i < example_ids.size(); i++) example_ids[i] = i;
+    return get_input_outputs(example_ids);
+}
+
+input_outputs_t exampleTable::get_input_outputs(const vector<int>& example_ids) {
+    return get_input_outputs(example_ids, get_outputs(example_ids));
+}
+
+input_outputs_t exampleTable::get_input_outputs(const vector<int>& example_ids, const vector<int>& labels) {
+    input_outputs_t input_outputs;
+    input_outputs.reserve(example_ids.size());
+    for (int i = 0; i < example_ids.size(); i++) {
+        input_output_t ioe;
+        for (int column = 0; column < _vars.size(); column++) {
+            ioe[_vars[column]] = _columns[column][example_ids[i]];
+        }
+        ioe["_out"] = labels[i];
+        input_outputs.push_back(ioe);
+    }
+    return input_outputs;
+}
@@ -0,0 +1,52 @@
+#ifndef EXAMPLETABLE_H
+#define EXAMPLETABLE_H
+
+#include "typeDef.hpp"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+ Immutable columnar table of the input-output examples of one file.
+ Examples are identified by their row, subsets of examples are vectors of
+ rows; input-output maps are only built when a search needs them.
+ */
+class exampleTable {
+public:
+    exampleTable() {}
+    exampleTable(input_outputs_t input_outputs);
+    /* in-memory table, one column of values per variable and the outputs, all of the same length */
+    exampleTable(vector<string> vars, vector<vector<int>> columns, vector<int> outputs);
+    
+    int size();
+    vector<string> get_vars();
+    /* column of a variable, -1 if the table has none */
+    int get_column(string var);
+    int get_value(int column, int example_id);
+    int get_output(int example_id);
+    vector<int> get_outputs(const vector<int>& example_ids);
+    
+    /* Table of the given examples, in the given order */
+    exampleTable select(const vector<int>& example_ids);
+    
+    /* Input-output map of one example, written over the map of the previous one */
+    void get_input_output(int example_id, input_output_t* ioe);
+    
+    /* Input-output maps of every example */
+    input_outputs_t get_input_outputs();
+    
+    /* Input-output maps of the given examples, with their own outputs or the given labels */
+    input_outputs_t get_input_outputs(const vector<int>& example_ids);
+    input_outputs_t get_input_outputs(const vector<int>& example_ids, const vector<int>& labels);
+
+private:
+    vector<string> _vars;
+    vector<vector<int>> _columns;
+    vector<int> _outputs;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include "ioeBuilder.hpp"
+#include <climits>
+#include <sys/wait.h>
+#include <unistd.h>
+/******************************************
+    Constructor
+ */
+ioeBuilder::ioeBuilder(string bench_name, string cache_config, double sampling_rate, int max_num_of_sampled, unsigned seed) : _sampler(1, seed) {
+    _bench_name = bench_name;
+    _cache_config = cache_config;
+    _sampling_rate = sampling_rate;
+    _max_num_of_sampled = max_num_of_sampled;
+}
+
+/******************************************
+    Records
+ */
+void ioeBuilder::trace(const string& tracer, const vector<int>& bounds) {
+    /* no shell in between, the arguments are built before forking */
+    vector<string> args = {tracer};
+    for (auto bound : bounds) args.push_back(to_string(bound));
+    vector<char*> argv;
+    for (auto &arg : args) argv.push_back(&arg[0]);
+    argv.push_back(nullptr);
+    
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0) throw runtime_error("Can not run tracer " + tracer);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(pipe_fds[0]);
+        close(pipe_fds[1]);
+        throw runtime_error("Can not run tracer " + tracer);
+    }
+    if (pid == 0) {
+        dup2(pipe_fds[1], STDOUT_FILENO);
+        close(pipe_fds[0]);
+        close(pipe_fds[1]);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    close(pipe_fds[1]);
+    
+    FILE* records = fdopen(pipe_fds[0], "r");
+    int status;
+    try {
+        if (records == nullptr) throw runtime_error("Can not read tracer " + tracer);
+        add_records(records, bounds);
+    } catch (...) {
+        if (records != nullptr) fclose(records); else close(pipe_fds[0]);
+        waitpid(pid, &status, 0);
+        throw;
+    }
+    fclose(records);
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) throw runtime_error("Tracer " + tracer + " failed");
+}
+
+void ioeBuilder::add_records(FILE* records, const vector<int>& bounds) {
+    int run = _bounds.size();
+    if (run > 0 && bounds.size() != _bounds[0].size()) throw runtime_error("Runs traced with different numbers of bounds");
+    _bounds.push_back(bounds);
+    
+    uint32_t ref_id, depth;
+    vector<int> iteration_vector;
+    uint64_t reuse_interval;
+    while (fread(&ref_id, sizeof(ref_id), 1, records) == 1) {
+        if (fread(&depth, sizeof(depth), 1, records) != 1 || depth > 64) throw runtime_error("Bad trace record of " + _bench_name);
+        iteration_vector.resize(depth);
+        if (fread(iteration_vector.data(), sizeof(int), depth, records) != depth ||
+            fread(&reuse_interval, sizeof(reuse_interval), 1, records) != 1) {
+            throw runtime_error("Truncated trace record of " + _bench_name);
+        }
+        
+        /* the first reuse of an access in a run, like the IOE generator */
+        auto key = make_pair((int)ref_id, iteration_vector);
+        if (run == 0) {
+            if (_reuse_intervals.find(key) == _reuse_intervals.end()) _reuse_intervals[key] = {reuse_interval};
+        } else {
+            auto it = _reuse_intervals.find(key);
+            if (it != _reuse_intervals.end() && it->second.size() == run) it->second.push_back(reuse_interval);
+        }
+    }
+    
+    if (run == 0) sample_accesses();
+    for (auto &access : _reuse_intervals) access.second.resize(run + 1, 0);
+}
+
+void ioeBuilder::sample_accesses() {
+    /* per reference, at most the sampling rate of its accesses and the maximum number over all references */
+    double sampling_rate = _sampling_rate;
+    if (!_reuse_intervals.empty()) sampling_rate = min(sampling_rate, (double)_max_num_of_sampled / _reuse_intervals.size());
+    
+    map<int, vector<pair<int, vector<int>>>> reference_accesses;
+    for (auto &access : _reuse_intervals) reference_accesses[access.first.first].push_back(access.first);
+    
+    map<pair<int, vector<int>>, vector<uint64_t>> sampled;
+    for (auto &reference : reference_accesses) {
+        vector<int> ids(reference.second.size());
+        for (int i = 0; i < ids.size(); i++) ids[i] = i;
+        int num_of_sampled = ceil(ids.size() * sampling_rate);
+        for (auto id : _sampler.pickIds(ids, num_of_sampled)) {
+            sampled[reference.second[id]] = _reuse_intervals[reference.second[id]];
+        }
+    }
+    _reuse_intervals = sampled;
+}
+
+/******************************************
+    Problems
+ */
+vector<traced_problem_t> ioeBuilder::take_problems() {
+    vector<traced_problem_t> problems;
+    for (auto &access : _reuse_intervals) {
+        traced_problem_t problem;
+        problem.ref_id = access.first.first;
+        const vector<int>& iteration_vector = access.first.second;
+        
+        string iteration_name;
+        for (int i = 0; i < iteration_vector.size(); i++) iteration_name += ((i > 0) ? "_" : "") + to_string(iteration_vector[i]);
+        problem.name = _bench_name + "_refsrc_" + to_string(problem.ref_id) + "_isrc_" + iteration_name + ".ri." + _cache_config;
+        
+        for (int run = 0; run < _bounds.size(); run++) {
+            input_output_t ioe;
+            for (int i = 0; i < iteration_vector.size(); i++) ioe["isrc" + to_string(i)] = iteration_vector[i];
+            for (int i = 0; i < _bounds[run].size(); i++) ioe["b" + to_string(i)] = _bounds[run][i];
+            ioe["_out"] = (int)min(access.second[run], (uint64_t)INT_MAX);
+            problem.input_outputs.push_back(ioe);
+        }
+        problems.push_back(problem);
+    }
+    _reuse_intervals.clear();
+    _bounds.clear();
+    return problems;
+}
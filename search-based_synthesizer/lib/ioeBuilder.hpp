@@ -0,0 +1,61 @@
+#ifndef IOEBUILDER_H
+#define IOEBUILDER_H
+
+#include "sampler.hpp"
+#include "typeDef.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/* Input-output examples of one source access over every traced bound vector */
+struct traced_problem_t {
+    string name;                    // the IOE file name it would have, bench_refsrc_R_isrc_I.ri.config
+    int ref_id;
+    input_outputs_t input_outputs;
+};
+
+/*
+ In-process IOE builder: groups the reuse records streamed by tracers built
+ with PROFILE_STREAM into the src_only input-output examples, without CSV
+ or IOE files in between.
+ Every run traces one bound vector. The source accesses are sampled on the
+ first run, the way the IOE generator samples them, and later runs only
+ keep the reuse intervals of the sampled accesses, 0 where an access has no
+ reuse.
+ */
+class ioeBuilder {
+public:
+    ioeBuilder(string bench_name, string cache_config, double sampling_rate = 0.2, int max_num_of_sampled = 20, unsigned seed = 0);
+    
+    /* run a tracer on a bound vector and read its records from a pipe, the tracer path is not run through a shell */
+    void trace(const string& tracer, const vector<int>& bounds);
+    
+    /* read the records of one run */
+    void add_records(FILE* records, const vector<int>& bounds);
+    
+    /* one problem per sampled source access, once every bound vector is traced */
+    vector<traced_problem_t> take_problems();
+
+private:
+    void sample_accesses();
+    
+    string _bench_name;
+    string _cache_config;
+    double _sampling_rate;
+    int _max_num_of_sampled;
+    sampler _sampler;
+    
+    /* bound vectors in the order of the runs */
+    vector<vector<int>> _bounds;
+    
+    /* reuse interval of every run, by source reference and iteration vector */
+    map<pair<int, vector<int>>, vector<uint64_t>> _reuse_intervals;
+};
+
+#endif
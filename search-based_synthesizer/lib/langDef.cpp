@@ -2900,16 +2900,27 @@ int Not::get_exponent_of_var(string var_name) {
 /******************************************
 Constructs: Ite
 */
-Ite::Ite(BoolType* cond, IntType* tcase, IntType* fcase) {
+Ite::Ite(BoolType* cond, IntType* tcase, IntType* fcase, bool is_split) {
     if (cond == nullptr) throw runtime_error("Ite: cond is null");
     if (tcase == nullptr) throw runtime_error("Ite: tcase is null");
     if (fcase == nullptr) throw runtime_error("Ite: fcase is null");
     _cond = cond;
     _tcase = tcase;
     _fcase = fcase;
+    _is_split = is_split;
     set_generation( max(cond->get_generation(), max(tcase->get_generation(), fcase->get_generation())) + 1 );
 }
 
+BoolType* Ite::get_cond() {
+    return _cond;
+}
+IntType* Ite::get_tcase() {
+    return _tcase;
+}
+IntType* Ite::get_fcase() {
+    return _fcase;
+}
+
 string Ite::to_string() {
     string output = "(if ";
     
@@ -2958,6 +2969,9 @@ string Ite::to_string() {
     else if (auto tcase = dynamic_cast<Rightshift*>(_tcase)) {
         output += tcase->to_string();
     }
+    else if (auto tcase = dynamic_cast<Ite*>(_tcase)) {
+        output += tcase->to_string();
+    }
     else {
         throw runtime_error("Ite::to_string() operates on UNKNOWN type!");
     }
@@ -2991,11 +3005,14 @@ string Ite::to_string() {
     else if (auto fcase = dynamic_cast<Rightshift*>(_fcase)) {
         output += fcase->to_string();
     }
+    else if (auto fcase = dynamic_cast<Ite*>(_fcase)) {
+        output += fcase->to_string();
+    }
     else {
         throw runtime_error("Ite::to_string() operates on UNKNOWN type!");
     }
     
-    output += " )";
+    output += _is_split ? ")" : " )";
     return output;
 }
     
@@ -3047,6 +3064,9 @@ int Ite::interpret(input_output_t env) {
     else if (auto tcase = dynamic_cast<Rightshift*>(_tcase)) {
         tcase_value = tcase->interpret(env);
     }
+    else if (auto tcase = dynamic_cast<Ite*>(_tcase)) {
+        tcase_value = tcase->interpret(env);
+    }
     else {
         throw runtime_error("Ite::interpret() operates on UNKOWN type!");
     }
@@ -3078,6 +3098,9 @@ int Ite::interpret(input_output_t env) {
     else if (auto fcase = dynamic_cast<Rightshift*>(_fcase)) {
         fcase_value = fcase->interpret(env);
     }
+    else if (auto fcase = dynamic_cast<Ite*>(_fcase)) {
+        fcase_value = fcase->interpret(env);
+    }
     else {
         throw runtime_error("Ite::interpret() operates on UNKOWN type!");
     }
@@ -3131,6 +3154,9 @@ int Ite::depth() {
     else if (auto tcase = dynamic_cast<Rightshift*>(_tcase)) {
         depth = max(depth, tcase->depth());
     }
+    else if (auto tcase = dynamic_cast<Ite*>(_tcase)) {
+        depth = max(depth, tcase->depth());
+    }
     else {
         throw runtime_error("Ite::depth() operates on UNKOWN type!");
     }
@@ -3162,6 +3188,9 @@ int Ite::depth() {
     else if (auto fcase = dynamic_cast<Rightshift*>(_fcase)) {
         depth = max(depth, fcase->depth()) + 1;
     }
+    else if (auto fcase = dynamic_cast<Ite*>(_fcase)) {
+        depth = max(depth, fcase->depth()) + 1;
+    }
     else {
         throw runtime_error("Ite::depth() operates on UNKOWN type!");
     }
@@ -246,11 +246,15 @@ private:
     BoolType* _cond;
     IntType* _tcase;
     IntType* _fcase;
+    bool _is_split;     // joins the branches of a unification split, printed the way unification prints them
 public:
-    Ite(BoolType* cond, IntType* tcase, IntType* fcase);
+    Ite(BoolType* cond, IntType* tcase, IntType* fcase, bool is_split = false);
     string to_string();
     int interpret(input_output_t env);
     int depth();
+    BoolType* get_cond();
+    IntType* get_tcase();
+    IntType* get_fcase();
     int get_number_of_ops(string op_name);
     int get_number_of_vars(string var_name);
     int get_exponent_of_var(string var_name);
@@ -0,0 +1,185 @@
+#include "mappedIOEFile.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+/******************************************
+    Constructor
+ */
+mappedIOEFile::mappedIOEFile(string file_name) {
+    _file_name = file_name;
+    
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) throw runtime_error("Can not open IOE file " + file_name);
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) < 0 || file_stat.st_size < 20) {
+        close(fd);
+        throw runtime_error("Not a binary IOE file " + file_name);
+    }
+    _file_size = file_stat.st_size;
+    void* data = mmap(nullptr, _file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) throw runtime_error("Can not map IOE file " + file_name);
+    _data = (const char*)data;
+    
+    /* header, checked against the file size before every read */
+    size_t offset = 0;
+    auto read_header = [this, &offset](void* value, size_t size) {
+        if (offset + size > _file_size) throw runtime_error("Truncated binary IOE file " + _file_name);
+        memcpy(value, _data + offset, size);
+        offset += size;
+    };
+    try {
+        char magic[4];
+        uint32_t version, num_of_columns;
+        uint64_t num_of_rows;
+        read_header(magic, 4);
+        read_header(&version, 4);
+        read_header(&num_of_columns, 4);
+        read_header(&num_of_rows, 8);
+        if (memcmp(magic, "IOEB", 4) != 0 || version != 1) throw runtime_error("Not a binary IOE file " + file_name);
+        _num_of_rows = num_of_rows;
+        
+        for (uint32_t column = 0; column < num_of_columns; column++) {
+            uint32_t name_length, width;
+            read_header(&name_length, 4);
+            if (name_length > _file_size - offset) throw runtime_error("Truncated binary IOE file " + file_name);
+            string name(name_length, '\0');
+            read_header(&name[0], name_length);
+            read_header(&width, 4);
+            if (width == 8) throw runtime_error("64-bit column " + name + " in binary IOE file " + file_name + ", the searches work on int");
+            if (width != 4) throw runtime_error("Bad column width in binary IOE file " + file_name);
+            if (name == "_out") _output_column = column;
+            _names.push_back(name);
+        }
+        if (_output_column == -1) throw runtime_error("No _out column in binary IOE file " + file_name);
+        
+        /* sizes are checked by division, a corrupt row count must not overflow them */
+        offset = (offset + 7) / 8 * 8;
+        for (uint32_t column = 0; column < num_of_columns; column++) {
+            if (offset > _file_size || _num_of_rows > (_file_size - offset) / 4) throw runtime_error("Truncated binary IOE file " + file_name);
+            _columns.push_back(_data + offset);
+            offset += (_num_of_rows * 4 + 7) / 8 * 8;
+        }
+    } catch (...) {
+        munmap((void*)_data, _file_size);
+        throw;
+    }
+}
+
+mappedIOEFile::~mappedIOEFile() {
+    munmap((void*)_data, _file_size);
+}
+
+bool mappedIOEFile::is_binary(string file_name) {
+    ifstream in(file_name, ios::binary);
+    char magic[4];
+    return in.read(magic, 4) && memcmp(magic, "IOEB", 4) == 0;
+}
+
+/******************************************
+    Converter
+ */
+void mappedIOEFile::convert(string text_file_name, string binary_file_name) {
+    ifstream in(text_file_name);
+    if (!in.is_open()) throw runtime_error("Can not read IOE file " + text_file_name);
+    
+    /* columns in the order of the first row, the output last */
+    vector<string> names;
+    vector<vector<int64_t>> columns;
+    map<string, int> column_of;
+    string line;
+    while (getline(in, line)) {
+        stringstream ss(line);
+        string var;
+        int64_t value;
+        vector<pair<string, int64_t>> row;
+        while (ss >> var >> value) row.push_back(make_pair(var, value));
+        if (row.empty()) continue;
+        
+        if (names.empty()) {
+            for (auto var_value : row) {
+                if (var_value.first != "_out") names.push_back(var_value.first);
+            }
+            names.push_back("_out");
+            for (int column = 0; column < names.size(); column++) column_of[names[column]] = column;
+            columns = vector<vector<int64_t>>(names.size());
+        }
+        if (row.size() != names.size()) throw runtime_error("Rows of different variables in IOE file " + text_file_name);
+        for (auto var_value : row) {
+            if (var_value.second < INT32_MIN || var_value.second > INT32_MAX) {
+                throw runtime_error("Value of " + var_value.first + " out of the int range in IOE file " + text_file_name);
+            }
+            auto it = column_of.find(var_value.first);
+            if (it == column_of.end()) throw runtime_error("Rows of different variables in IOE file " + text_file_name);
+            columns[it->second].push_back(var_value.second);
+        }
+    }
+    if (names.empty()) throw runtime_error("No examples in IOE file " + text_file_name);
+    
+    ofstream out(binary_file_name, ios::binary | ios::trunc);
+    if (!out.is_open()) throw runtime_error("Can not write binary IOE file " + binary_file_name);
+    auto write_value = [&out](const void* value, size_t size) {
+        out.write((const char*)value, size);
+    };
+    auto pad = [&out]() {
+        while (out.tellp() % 8 != 0) out.put('\0');
+    };
+    
+    uint32_t version = 1;
+    uint32_t num_of_columns = names.size();
+    uint64_t num_of_rows = columns[0].size();
+    out.write("IOEB", 4);
+    write_value(&version, 4);
+    write_value(&num_of_columns, 4);
+    write_value(&num_of_rows, 8);
+    
+    for (int column = 0; column < names.size(); column++) {
+        uint32_t width = 4;
+        uint32_t name_length = names[column].size();
+        write_value(&name_length, 4);
+        out.write(names[column].data(), name_length);
+        write_value(&width, 4);
+    }
+    pad();
+    
+    for (int column = 0; column < names.size(); column++) {
+        for (auto value : columns[column]) {
+            int32_t narrow = value;
+            write_value(&narrow, 4);
+        }
+        pad();
+    }
+    if (!out) throw runtime_error("Can not write binary IOE file " + binary_file_name);
+}
+
+/******************************************
+    Accessors
+ */
+int mappedIOEFile::size() {
+    return _num_of_rows;
+}
+
+vector<string> mappedIOEFile::get_vars() {
+    vector<string> vars;
+    for (int column = 0; column < _names.size(); column++) {
+        if (column != _output_column) vars.push_back(_names[column]);
+    }
+    return vars;
+}
+
+exampleTable mappedIOEFile::get_example_table() {
+    vector<string> vars = get_vars();
+    sort(vars.begin(), vars.end());
+    
+    auto read_column = [this](int column) -> vector<int> {
+        const int32_t* values = (const int32_t*)_columns[column];
+        return vector<int>(values, values + _num_of_rows);
+    };
+    vector<vector<int>> columns;
+    for (auto var : vars) {
+        int column = find(_names.begin(), _names.end(), var) - _names.begin();
+        columns.push_back(read_column(column));
+    }
+    return exampleTable(vars, move(columns), read_column(_output_column));
+}
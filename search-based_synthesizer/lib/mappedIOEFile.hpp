@@ -0,0 +1,61 @@
+#ifndef MAPPEDIOEFILE_H
+#define MAPPEDIOEFILE_H
+
+#include "exampleTable.hpp"
+#include "typeDef.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+ Binary columnar IOE file, read through a memory mapping.
+ Text IOE files repeat every variable name on every row and are parsed line
+ by line. A binary file names the columns once in its header, then stores
+ the values column after column, so it is read column by column into an
+ example table without parsing.
+ 
+ Layout, little endian:
+     "IOEB", uint32 version, uint32 number of columns, uint64 number of rows
+     per column: uint32 name length, name, uint32 value width (4)
+     padding to 8 bytes
+     per column: the values as int32, padded to 8 bytes
+ The output column is named _out. The searches work on int, so values that
+ need 64 bits are rejected rather than truncated.
+ */
+class mappedIOEFile {
+public:
+    mappedIOEFile(string file_name);
+    ~mappedIOEFile();
+    
+    /* Whether a file starts like a binary IOE file */
+    static bool is_binary(string file_name);
+    
+    /* Convert a text IOE file to a binary one */
+    static void convert(string text_file_name, string binary_file_name);
+    
+    int size();
+    vector<string> get_vars();
+    
+    /* Examples as a table, the variables sorted by name like the keys of input-output maps */
+    exampleTable get_example_table();
+
+private:
+    
+    string _file_name;
+    const char* _data = nullptr;
+    size_t _file_size = 0;
+    
+    size_t _num_of_rows = 0;
+    vector<string> _names;
+    vector<const char*> _columns;
+    int _output_column = -1;
+};
+
+#endif
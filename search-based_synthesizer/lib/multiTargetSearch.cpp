@@ -0,0 +1,126 @@
+#include "multiTargetSearch.hpp"
+/******************************************
+    Constructor
+ */
+multiTargetSearch::multiTargetSearch(int depth_bound,
+                                     vector<string> int_ops,
+                                     vector<string> bool_ops,
+                                     vector<string> constants,
+                                     vector<string> rules_to_apply,
+                                     string bench_name,
+                                     int num_growing_speed,
+                                     int num_growing_upperbound) {
+    _depth_bound = depth_bound;
+    _int_ops = int_ops;
+    _bool_ops = bool_ops;
+    _constants = constants;
+    _rules_to_apply = rules_to_apply;
+    _bench_name = bench_name;
+    _num_growing_speed = num_growing_speed;
+    _num_growing_upperbound = num_growing_upperbound;
+}
+
+void multiTargetSearch::add_target(string file_name, int ref_id, input_outputs_t input_outputs) {
+    if (input_outputs.empty()) throw runtime_error("No input-output examples in " + file_name);
+    
+    /* terms only read bound variables, like the term searches of bottomUpSearch */
+    vector<string> bound_vars;
+    for (auto var_value : input_outputs[0]) {
+        if (var_value.first != "_out" && var_value.first.find("b") != string::npos) {
+            bound_vars.push_back(var_value.first);
+        }
+    }
+    
+    term_target_t target;
+    target.file_name = file_name;
+    target.ref_id = ref_id;
+    target.is_term_target = true;
+    map<vector<int>, int> grid_outputs;
+    for (auto ioe : input_outputs) {
+        if (ioe.find("_out") == ioe.end()) throw runtime_error("No _out entry in IOE");
+        vector<int> point;
+        for (auto var : bound_vars) point.push_back(ioe[var]);
+        auto it = grid_outputs.find(point);
+        if (it != grid_outputs.end() && it->second != ioe["_out"]) {
+            target.is_term_target = false;
+        }
+        grid_outputs[point] = ioe["_out"];
+    }
+    
+    vector<vector<int>> grid;
+    for (auto point_output : grid_outputs) {
+        grid.push_back(point_output.first);
+        target.outputs.push_back(point_output.second);
+    }
+    
+    int target_id = _targets.size();
+    _targets.push_back(target);
+    if (!target.is_term_target) return;
+    
+    for (auto &group : _groups) {
+        if (group.ref_id == ref_id && group.bound_vars == bound_vars && group.grid == grid) {
+            group.target_ids.push_back(target_id);
+            return;
+        }
+    }
+    _groups.push_back({ref_id, bound_vars, grid, {target_id}});
+}
+
+/******************************************
+    Search
+ */
+void multiTargetSearch::search(int search_time_in_seconds) {
+    for (auto group : _groups) {
+        /* the output bound of the value elimination has to hold for every target of the group */
+        input_outputs_t input_outputs;
+        vector<vector<int>> targets;
+        for (auto target_id : group.target_ids) targets.push_back(_targets[target_id].outputs);
+        for (int point = 0; point < group.grid.size(); point++) {
+            input_output_t ioe;
+            for (int i = 0; i < group.bound_vars.size(); i++) {
+                ioe[group.bound_vars[i]] = group.grid[point][i];
+            }
+            int output_bound = 0;
+            bool has_zero = false;
+            for (auto target : targets) {
+                output_bound = max(output_bound, target[point]);
+                has_zero = has_zero || (target[point] == 0);
+            }
+            ioe["_out"] = has_zero ? 0 : output_bound;
+            input_outputs.push_back(ioe);
+        }
+
+#ifdef DEBUG
+        cout << "Search " << targets.size() << " targets of reference " << group.ref_id << " over " << group.grid.size() << " grid points" << endl;
+#endif
+        bottomUpSearch* bus = new bottomUpSearch(_depth_bound,
+                                                 _int_ops,
+                                                 _bool_ops,
+                                                 group.bound_vars,
+                                                 _constants,
+                                                 false,
+                                                 _rules_to_apply,
+                                                 _bench_name,
+                                                 group.ref_id,
+                                                 _num_growing_speed,
+                                                 _num_growing_upperbound,
+                                                 input_outputs);
+        bus->set_search_control(make_shared<searchControl>(search_time_in_seconds));
+        vector<BaseType*> programs = bus->search_programs_for_targets(targets);
+        for (int i = 0; i < programs.size(); i++) {
+            if (programs[i] != nullptr) _targets[group.target_ids[i]].searched_program = programs[i]->to_string();
+        }
+        delete bus;
+    }
+}
+
+/******************************************
+    Dumping functions
+ */
+const vector<term_target_t>& multiTargetSearch::get_targets() {
+    return _targets;
+}
+
+int multiTargetSearch::get_num_of_groups() {
+    return _groups.size();
+}
@@ -0,0 +1,75 @@
+#ifndef MULTITARGETSEARCH_H
+#define MULTITARGETSEARCH_H
+
+#include "bottomUpSearch.hpp"
+#include "searchControl.hpp"
+#include "typeDef.hpp"
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//#define DEBUG
+
+/* Examples of one file, as outputs over the bound grid of its group */
+struct term_target_t {
+    string file_name;
+    int ref_id;
+    vector<int> outputs;
+    bool is_term_target;            // false when one grid point has several outputs, left to a unification
+    string searched_program;
+};
+
+/*
+ Multi-target term search: the IOE files of a benchmark share one grid of
+ bound variables, and terms only read bound variables. Files of the same
+ reference and grid are searched by one enumeration, every new term is looked
+ up among the output vectors of the files still pending.
+ */
+class multiTargetSearch {
+public:
+    multiTargetSearch(int depth_bound,
+                      vector<string> int_ops,
+                      vector<string> bool_ops,
+                      vector<string> constants,
+                      vector<string> rules_to_apply,
+                      string bench_name,
+                      int num_growing_speed,
+                      int num_growing_upperbound);
+    
+    /* add the examples of one file, its reference decides the grow rules */
+    void add_target(string file_name, int ref_id, input_outputs_t input_outputs);
+    
+    /* one enumeration per group, each bounded by the search time */
+    void search(int search_time_in_seconds);
+    
+    /* every file added, with the program searched for it if any */
+    const vector<term_target_t>& get_targets();
+    int get_num_of_groups();
+
+private:
+    /* files of the same reference over the same bound variables and grid points */
+    struct target_group_t {
+        int ref_id;
+        vector<string> bound_vars;
+        vector<vector<int>> grid;
+        vector<int> target_ids;
+    };
+    
+    vector<term_target_t> _targets;
+    vector<target_group_t> _groups;
+    
+    /* Language defination */
+    int _depth_bound;
+    vector<string> _int_ops;
+    vector<string> _bool_ops;
+    vector<string> _constants;
+    vector<string> _rules_to_apply;
+    string _bench_name;
+    int _num_growing_speed;
+    int _num_growing_upperbound;
+};
+
+#endif
@@ -0,0 +1,355 @@
+#include "predicateLearner.hpp"
+/******************************************
+    Constructor
+ */
+predicateLearner::predicateLearner(int depth_bound,
+                                   vector<string> int_ops,
+                                   vector<string> vars,
+                                   vector<string> constants,
+                                   vector<string> rules_to_apply,
+                                   string bench_name,
+                                   int ref_id,
+                                   int num_growing_speed,
+                                   int num_growing_upperbound,
+                                   input_outputs_t input_outputs,
+                                   int atom_generation_bound,
+                                   int tree_depth_bound) {
+    _depth_bound = depth_bound;
+    _int_ops = int_ops;
+    _vars = vars;
+    _constants = constants;
+    _rules_to_apply = rules_to_apply;
+    _bench_name = bench_name;
+    _ref_id = ref_id;
+    _num_growing_speed = num_growing_speed;
+    _num_growing_upperbound = num_growing_upperbound;
+    _input_outputs = input_outputs;
+    _atom_generation_bound = atom_generation_bound;
+    _tree_depth_bound = tree_depth_bound;
+    
+    _arena = new programArena();
+    
+    _num_of_examples = _input_outputs.size();
+    _num_of_words = (_num_of_examples + 63) / 64;
+    
+    _positive = make_bitset(false);
+    for (int i = 0; i < _num_of_examples; i++) {
+        if (_input_outputs[i].find("_out") == _input_outputs[i].end()) throw runtime_error("No _out entry in IOE");
+        if (_input_outputs[i]["_out"] == 1) {
+            _positive[i / 64] |= (uint64_t(1) << (i % 64));
+        }
+    }
+}
+
+predicateLearner::~predicateLearner() {
+    delete _atom_enumerator;
+    delete _arena;
+}
+
+void predicateLearner::set_search_control(shared_ptr<searchControl> search_control) {
+    _search_control = search_control;
+    if (_atom_enumerator != nullptr) _atom_enumerator->set_search_control(search_control);
+}
+
+void predicateLearner::move_programs_to(programArena* arena) {
+    if (_atom_enumerator != nullptr) _atom_enumerator->move_programs_to(arena);
+    arena->adopt(_arena);
+}
+
+search_profile_t predicateLearner::take_profile() {
+    if (_atom_enumerator == nullptr) return search_profile_t();
+    return _atom_enumerator->take_profile();
+}
+
+/******************************************
+    Bitset helpers
+ */
+inline example_bitset_t predicateLearner::make_bitset(bool value) {
+    example_bitset_t bits(_num_of_words, value ? ~uint64_t(0) : uint64_t(0));
+    if (value && _num_of_examples % 64 != 0) {
+        bits.back() = (uint64_t(1) << (_num_of_examples % 64)) - 1;
+    }
+    return bits;
+}
+
+inline int predicateLearner::count(const example_bitset_t& bits) {
+    int cnt = 0;
+    for (auto word : bits) cnt += __builtin_popcountll(word);
+    return cnt;
+}
+
+inline example_bitset_t predicateLearner::bit_and(const example_bitset_t& a, const example_bitset_t& b) {
+    example_bitset_t bits(_num_of_words);
+    for (int i = 0; i < _num_of_words; i++) bits[i] = a[i] & b[i];
+    return bits;
+}
+
+inline example_bitset_t predicateLearner::bit_and_not(const example_bitset_t& a, const example_bitset_t& b) {
+    example_bitset_t bits(_num_of_words);
+    for (int i = 0; i < _num_of_words; i++) bits[i] = a[i] & ~b[i];
+    return bits;
+}
+
+inline double predicateLearner::entropy(int positive, int total) {
+    if (total == 0 || positive == 0 || positive == total) return 0.0;
+    double p = (double)positive / total;
+    return -p * log2(p) - (1 - p) * log2(1 - p);
+}
+
+/******************************************
+    Atom library
+ */
+bool predicateLearner::build_atom_library(int generation_bound) {
+    if (_atom_enumerator == nullptr) {
+        vector<string> bool_ops = {"LT"};
+        _atom_enumerator = new bottomUpSearch(_depth_bound,
+                                              _int_ops,
+                                              bool_ops,
+                                              _vars,
+                                              _constants,
+                                              true,
+                                              _rules_to_apply,
+                                              _bench_name,
+                                              _ref_id,
+                                              _num_growing_speed,
+                                              _num_growing_upperbound,
+                                              _input_outputs);
+        _atom_enumerator->set_search_control(_search_control);
+    }
+    vector<BaseType*> programs = _atom_enumerator->enumerate(generation_bound);
+    
+    int num_of_atoms = _atoms.size();
+    example_bitset_t all = make_bitset(true);
+    for (auto program : programs) {
+        if (_visited_programs.find(program) != _visited_programs.end()) continue;
+        _visited_programs.insert(program);
+        
+        auto lt = dynamic_cast<Lt*>(program);
+        if (lt == nullptr) continue;
+        
+        example_bitset_t bits = make_bitset(false);
+        for (int i = 0; i < _num_of_examples; i++) {
+            if (lt->interpret(_input_outputs[i])) {
+                bits[i / 64] |= (uint64_t(1) << (i % 64));
+            }
+        }
+        
+        /* an atom and its complement split the examples the same way */
+        example_bitset_t complement = bit_and_not(all, bits);
+        if (_seen_bits.find(bits) != _seen_bits.end() || _seen_bits.find(complement) != _seen_bits.end()) continue;
+        _seen_bits.insert(bits);
+        
+        _atoms.push_back(lt);
+        _atom_bits.push_back(bits);
+    }
+
+#ifdef DEBUG
+    cout << "Atom library size " << _atoms.size() << " at generation " << generation_bound << endl;
+#endif
+    return _atoms.size() != num_of_atoms;
+}
+
+/******************************************
+    Greedy conjunction: keep all positives, drop negatives
+ */
+BoolType* predicateLearner::learn_conjunction() {
+    example_bitset_t all = make_bitset(true);
+    
+    for (int polarity = 1; polarity >= 0; polarity--) {
+        example_bitset_t positive = polarity ? _positive : bit_and_not(all, _positive);
+        example_bitset_t remaining = bit_and_not(all, positive);
+        BoolType* conjunction = nullptr;
+        
+        while (count(remaining) != 0) {
+            int best_id = -1;
+            bool best_negated = false;
+            int best_removed = 0;
+            for (int i = 0; i < _atoms.size(); i++) {
+                for (int negated = 0; negated < 2; negated++) {
+                    example_bitset_t literal = negated ? bit_and_not(all, _atom_bits[i]) : _atom_bits[i];
+                    if (count(bit_and_not(positive, literal)) != 0) continue;
+                    int removed = count(bit_and_not(remaining, literal));
+                    if (removed > best_removed) {
+                        best_removed = removed;
+                        best_id = i;
+                        best_negated = negated;
+                    }
+                }
+            }
+            if (best_id == -1) break;
+            
+            BoolType* literal = _atoms[best_id];
+            if (best_negated) literal = keep(new Not(literal));
+            conjunction = (conjunction == nullptr) ? literal : keep(new And(conjunction, literal));
+            remaining = bit_and(remaining, best_negated ? bit_and_not(all, _atom_bits[best_id]) : _atom_bits[best_id]);
+        }
+        
+        if (count(remaining) == 0 && conjunction != nullptr) {
+            return polarity ? conjunction : keep(new Not(conjunction));
+        }
+    }
+    
+    return nullptr;
+}
+
+/******************************************
+    Greedy decision tree by information gain
+ */
+decision_tree_node* predicateLearner::build_decision_tree(const example_bitset_t& examples, int depth) {
+    int total = count(examples);
+    int positive = count(bit_and(examples, _positive));
+    
+    if (positive == total) return keep_node(new decision_tree_node(true));
+    if (positive == 0) return keep_node(new decision_tree_node(false));
+    if (depth >= _tree_depth_bound) return nullptr;
+    if (_search_control != nullptr && _search_control->is_stopped()) return nullptr;
+    
+    double parent_entropy = entropy(positive, total);
+    int best_id = -1;
+    double best_gain = 0.0;
+    for (int i = 0; i < _atoms.size(); i++) {
+        example_bitset_t t_examples = bit_and(examples, _atom_bits[i]);
+        int t_total = count(t_examples);
+        if (t_total == 0 || t_total == total) continue;
+        int t_positive = count(bit_and(t_examples, _positive));
+        
+        double gain = parent_entropy
+                    - (double)t_total / total * entropy(t_positive, t_total)
+                    - (double)(total - t_total) / total * entropy(positive - t_positive, total - t_total);
+        if (gain > best_gain) {
+            best_gain = gain;
+            best_id = i;
+        }
+    }
+    if (best_id == -1) return nullptr;
+    
+    decision_tree_node* tcase = build_decision_tree(bit_and(examples, _atom_bits[best_id]), depth + 1);
+    if (tcase == nullptr) return nullptr;
+    decision_tree_node* fcase = build_decision_tree(bit_and_not(examples, _atom_bits[best_id]), depth + 1);
+    if (fcase == nullptr) return nullptr;
+    
+    return keep_node(new decision_tree_node(best_id, tcase, fcase));
+}
+
+/* a || b == !(!a && !b) */
+BoolType* predicateLearner::make_or(BoolType* left, BoolType* right) {
+    return keep(new Not(keep(new And(keep(new Not(left)), keep(new Not(right))))));
+}
+
+BoolType* predicateLearner::tree_to_predicate(decision_tree_node* node, bool* is_const, bool* const_value) {
+    if (node->atom_id == -1) {
+        *is_const = true;
+        *const_value = node->label;
+        return nullptr;
+    }
+    
+    bool t_const, t_value, f_const, f_value;
+    BoolType* tcase = tree_to_predicate(node->tcase, &t_const, &t_value);
+    BoolType* fcase = tree_to_predicate(node->fcase, &f_const, &f_value);
+    BoolType* atom = _atoms[node->atom_id];
+    
+    *is_const = false;
+    if (t_const && f_const) {
+        if (t_value == f_value) {
+            *is_const = true;
+            *const_value = t_value;
+            return nullptr;
+        }
+        return t_value ? atom : keep(new Not(atom));
+    }
+    if (t_const) {
+        // atom ? t_value : fcase
+        return t_value ? make_or(atom, fcase) : keep(new And(keep(new Not(atom)), fcase));
+    }
+    if (f_const) {
+        // atom ? tcase : f_value
+        return f_value ? make_or(keep(new Not(atom)), tcase) : keep(new And(atom, tcase));
+    }
+    return make_or(keep(new And(atom, tcase)), keep(new And(keep(new Not(atom)), fcase)));
+}
+
+BoolType* predicateLearner::learn_decision_tree() {
+    decision_tree_node* root = build_decision_tree(make_bitset(true), 0);
+    if (root == nullptr) return nullptr;
+    
+    bool is_const, const_value;
+    return tree_to_predicate(root, &is_const, &const_value);
+}
+
+/******************************************
+    Check correct
+ */
+bool predicateLearner::is_correct(BoolType* predicate) {
+    if (predicate == nullptr) return false;
+    for (int i = 0; i < _num_of_examples; i++) {
+        bool value;
+        if (auto lt = dynamic_cast<Lt*>(predicate)) {
+            value = lt->interpret(_input_outputs[i]);
+        }
+        else if (auto a = dynamic_cast<And*>(predicate)) {
+            value = a->interpret(_input_outputs[i]);
+        }
+        else if (auto n = dynamic_cast<Not*>(predicate)) {
+            value = n->interpret(_input_outputs[i]);
+        }
+        else {
+            throw runtime_error("predicateLearner::is_correct() operates on UNKNOWN type!");
+        }
+        if (value != (_input_outputs[i]["_out"] == 1)) return false;
+    }
+    return true;
+}
+
+/******************************************
+    Learn
+ */
+string predicateLearner::learn() {
+    BoolType* predicate = learn_program();
+    if (predicate == nullptr) {
+        return "";
+    }
+    return predicate->to_string();
+}
+
+BoolType* predicateLearner::learn_program() {
+    for (auto ioe : _input_outputs) {
+        if (!(ioe["_out"] == 0 || ioe["_out"] == 1)) {
+            return nullptr;
+        }
+    }
+    
+    /* grow the atom library one generation at a time until the examples are separated */
+    int generation_bound = _atom_generation_bound;
+    while (true) {
+        bool has_new_atoms = build_atom_library(generation_bound);
+        if (_search_control != nullptr && _search_control->is_stopped()) break;
+        
+        if (has_new_atoms) {
+            /* all examples on one side, any atom constant over them is accepted, same as bottomUpSearch */
+            int positive = count(_positive);
+            if (positive == 0 || positive == _num_of_examples) {
+                for (int i = 0; i < _atoms.size(); i++) {
+                    int cnt = count(_atom_bits[i]);
+                    if (cnt == 0 || cnt == _num_of_examples) return _atoms[i];
+                }
+            }
+            else {
+                BoolType* predicate = learn_conjunction();
+                if (!is_correct(predicate)) {
+                    predicate = learn_decision_tree();
+                }
+                if (is_correct(predicate)) {
+#ifdef DEBUG
+                    cout << "Learned predicate: " << predicate->to_string() << endl;
+#endif
+                    return predicate;
+                }
+            }
+        }
+        
+        if (!_atom_enumerator->has_more_programs()) break;
+        generation_bound++;
+    }
+    
+    return nullptr;
+}
@@ -0,0 +1,134 @@
+#ifndef PREDICATELEARNER_H
+#define PREDICATELEARNER_H
+
+#include "bottomUpSearch.hpp"
+#include "langDef.hpp"
+#include "typeDef.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <vector>
+
+using namespace std;
+
+//#define DEBUG
+
+/* one bit per input-output example */
+typedef vector<uint64_t> example_bitset_t;
+
+struct decision_tree_node {
+    int atom_id;                    // -1 for leaves
+    bool label;                     // valid for leaves only
+    decision_tree_node *tcase;      // examples satisfying the atom
+    decision_tree_node *fcase;      // examples violating the atom
+    decision_tree_node(bool l) : atom_id(-1), label(l), tcase(nullptr), fcase(nullptr) {}
+    decision_tree_node(int id, decision_tree_node *t, decision_tree_node *f) : atom_id(id), label(false), tcase(t), fcase(f) {}
+};
+
+/*
+ Predicate learner: enumerate atomic Lt comparisons once, evaluate them as
+ bitsets over the examples, then greedily build a conjunction or a decision
+ tree by information gain and convert it back to And/Not/Lt syntax.
+ */
+class predicateLearner {
+public:
+    predicateLearner(int depth_bound,
+                     vector<string> int_ops,
+                     vector<string> vars,
+                     vector<string> constants,
+                     vector<string> rules_to_apply,
+                     string bench_name,
+                     int ref_id,
+                     int num_growing_speed,
+                     int num_growing_upperbound,
+                     input_outputs_t input_outputs,
+                     int atom_generation_bound = 2,
+                     int tree_depth_bound = 4);
+    
+    ~predicateLearner();
+    
+    /* learn function, returns "" if no predicate separates the examples */
+    string learn();
+    BoolType* learn_program();
+    
+    /* cooperative deadline and cancellation */
+    void set_search_control(shared_ptr<searchControl> search_control);
+    
+    /* hand the programs the learner allocated to a longer-lived arena */
+    void move_programs_to(programArena* arena);
+    
+    /* time spent enumerating atoms and their numbers per generation since the last call */
+    search_profile_t take_profile();
+
+private:
+    /* Build the atom library, extending it up to the given generation */
+    bool build_atom_library(int generation_bound);
+    
+    /* Learners */
+    BoolType* learn_conjunction();
+    BoolType* learn_decision_tree();
+    decision_tree_node* build_decision_tree(const example_bitset_t& examples, int depth);
+    
+    /* Convert learned structures back to And/Not/Lt syntax */
+    BoolType* tree_to_predicate(decision_tree_node* node, bool* is_const, bool* const_value);
+    BoolType* make_or(BoolType* left, BoolType* right);
+    
+    /* Check learned predicate on the examples */
+    bool is_correct(BoolType* predicate);
+    
+    /* Allocate learner-owned programs and tree nodes */
+    template <typename T>
+    T* keep(T* program) {
+        _arena->add(program);
+        return program;
+    }
+    decision_tree_node* keep_node(decision_tree_node* node) {
+        _tree_nodes.push_back(unique_ptr<decision_tree_node>(node));
+        return node;
+    }
+    
+    /* Bitset helpers */
+    inline example_bitset_t make_bitset(bool value);
+    inline int count(const example_bitset_t& bits);
+    inline example_bitset_t bit_and(const example_bitset_t& a, const example_bitset_t& b);
+    inline example_bitset_t bit_and_not(const example_bitset_t& a, const example_bitset_t& b);
+    inline double entropy(int positive, int total);
+    
+    /* Atom library */
+    bottomUpSearch* _atom_enumerator = nullptr;
+    set<BaseType*> _visited_programs;
+    set<example_bitset_t> _seen_bits;
+    vector<Lt*> _atoms;
+    vector<example_bitset_t> _atom_bits;
+    
+    /* Learner-owned And/Not nodes and decision trees */
+    programArena* _arena;
+    vector<unique_ptr<decision_tree_node>> _tree_nodes;
+    
+    shared_ptr<searchControl> _search_control;
+    
+    /* Input-output examples and their labels */
+    input_outputs_t _input_outputs;
+    example_bitset_t _positive;
+    int _num_of_examples;
+    int _num_of_words;
+    
+    /* Language defination */
+    int _depth_bound;
+    vector<string> _int_ops;
+    vector<string> _vars;
+    vector<string> _constants;
+    vector<string> _rules_to_apply;
+    string _bench_name;
+    int _ref_id;
+    int _num_growing_speed;
+    int _num_growing_upperbound;
+    
+    /* Learner configuration */
+    int _atom_generation_bound;
+    int _tree_depth_bound;
+};
+
+#endif
@@ -0,0 +1,176 @@
+#include "programBank.hpp"
+/******************************************
+    Constructor
+ */
+programArena::programArena(size_t capacity) {
+    _capacity = capacity;
+}
+
+programArena::~programArena() {
+    for (auto program : _programs) {
+        delete program;
+    }
+}
+
+bool programArena::add(BaseType* program) {
+    unique_lock<mutex> lock(_mutex);
+    if (_capacity != 0 && _programs.size() >= _capacity) {
+        return false;
+    }
+    _programs.push_back(program);
+    return true;
+}
+
+void programArena::adopt(programArena* other) {
+    if (other == nullptr || other == this) return;
+    unique_lock<mutex> lock(_mutex);
+    unique_lock<mutex> other_lock(other->_mutex);
+    _programs.insert(_programs.end(), other->_programs.begin(), other->_programs.end());
+    other->_programs.clear();
+    _banks.insert(other->_banks.begin(), other->_banks.end());
+    other->_banks.clear();
+}
+
+void programArena::keep_bank(shared_ptr<programBank> bank) {
+    unique_lock<mutex> lock(_mutex);
+    _banks.insert(bank);
+}
+
+size_t programArena::size() {
+    unique_lock<mutex> lock(_mutex);
+    return _programs.size();
+}
+
+programBank::programBank(string language_key) {
+    _language_key = language_key;
+    _num_of_lookups = 0;
+    _num_of_hits = 0;
+}
+
+programBank::~programBank() {
+    for (auto var : _vars) delete var.second;
+    for (auto num : _nums) delete num.second;
+    for (auto grown : _grown_programs) delete grown.second;
+}
+
+shared_ptr<programBank> programBank::get_bank(string language_key) {
+    /* most recently used first */
+    static list<pair<string, shared_ptr<programBank>>> banks;
+    static map<string, list<pair<string, shared_ptr<programBank>>>::iterator> bank_of_key;
+    static mutex banks_mutex;
+    
+    unique_lock<mutex> lock(banks_mutex);
+    auto it = bank_of_key.find(language_key);
+    if (it != bank_of_key.end()) {
+        banks.splice(banks.begin(), banks, it->second);
+    } else {
+        banks.push_front(make_pair(language_key, make_shared<programBank>(language_key)));
+        bank_of_key[language_key] = banks.begin();
+    }
+    shared_ptr<programBank> bank = banks.front().second;
+    
+    /* evict the least recently used banks, the searches holding them keep them until they finish */
+    size_t total_size = 0;
+    for (auto &key_bank : banks) total_size += key_bank.second->size();
+    while (banks.size() > 1 && total_size > _registry_capacity) {
+        total_size -= banks.back().second->size();
+        bank_of_key.erase(banks.back().first);
+        banks.pop_back();
+    }
+    return bank;
+}
+
+/******************************************
+    Shared leaves
+ */
+Var* programBank::get_var(string name) {
+    unique_lock<shared_mutex> lock(_mutex);
+    auto it = _vars.find(name);
+    if (it != _vars.end()) {
+        return it->second;
+    }
+    Var* var = new Var(name);
+    var->set_generation(1);
+    _vars[name] = var;
+    return var;
+}
+
+Num* programBank::get_num(int value) {
+    unique_lock<shared_mutex> lock(_mutex);
+    auto it = _nums.find(value);
+    if (it != _nums.end()) {
+        return it->second;
+    }
+    Num* num = new Num(value);
+    num->set_generation(1);
+    _nums[value] = num;
+    return num;
+}
+
+/******************************************
+    Grown programs
+ */
+inline int programBank::get_op_id(string op) {
+    if (op == "PLUS") return 0;
+    else if (op == "MINUS") return 1;
+    else if (op == "TIMES") return 2;
+    else if (op == "LEFTSHIFT") return 3;
+    else if (op == "RIGHTSHIFT") return 4;
+    else if (op == "ITE") return 5;
+    else if (op == "NOT") return 6;
+    else if (op == "AND") return 7;
+    else if (op == "LT") return 8;
+    else if (op == "F") return 9;
+    throw runtime_error("programBank::get_op_id() operates on UNKNOWN op: " + op);
+}
+
+bool programBank::lookup(string op, BaseType* operand_a, BaseType* operand_b, BaseType* operand_c, int program_generation, BaseType** program) {
+    _num_of_lookups++;
+    grow_key_t key = {get_op_id(op), program_generation, operand_a, operand_b, operand_c};
+    shared_lock<shared_mutex> lock(_mutex);
+    auto it = _grown_programs.find(key);
+    if (it == _grown_programs.end()) {
+        return false;
+    }
+    _num_of_hits++;
+    *program = it->second;
+    return true;
+}
+
+BaseType* programBank::record(string op, BaseType* operand_a, BaseType* operand_b, BaseType* operand_c, int program_generation, BaseType* program) {
+    grow_key_t key = {get_op_id(op), program_generation, operand_a, operand_b, operand_c};
+    unique_lock<shared_mutex> lock(_mutex);
+    
+    auto it = _grown_programs.find(key);
+    if (it != _grown_programs.end()) {
+        delete program;
+        return it->second;
+    }
+    /* stop remembering once the bank is full, programs are still handed out */
+    if (_grown_programs.size() >= _capacity) {
+        return nullptr;
+    }
+    if (program != nullptr) {
+        _num_of_skeletons_per_generation[program_generation]++;
+    }
+    _grown_programs[key] = program;
+    return program;
+}
+
+size_t programBank::size() {
+    shared_lock<shared_mutex> lock(_mutex);
+    return _grown_programs.size();
+}
+
+/******************************************
+    Dumping function
+ */
+void programBank::dump_statistics() {
+    shared_lock<shared_mutex> lock(_mutex);
+    cout << "Program bank " << _language_key << endl;
+    cout << "    grown programs recorded: " << _grown_programs.size() << endl;
+    cout << "    lookups: " << _num_of_lookups << " hits: " << _num_of_hits << endl;
+    for (auto [generation, num_of_skeletons] : _num_of_skeletons_per_generation) {
+        cout << "    generation " << generation << ": " << num_of_skeletons << " skeletons" << endl;
+    }
+}
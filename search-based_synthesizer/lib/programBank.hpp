@@ -0,0 +1,134 @@
+#ifndef PROGRAMBANK_H
+#define PROGRAMBANK_H
+
+#include "langDef.hpp"
+#include "typeDef.hpp"
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//#define DEBUG
+
+struct grow_key_t {
+    int op;
+    int generation;
+    BaseType* operand_a;
+    BaseType* operand_b;
+    BaseType* operand_c;
+    bool operator==(const grow_key_t& other) const {
+        return op == other.op && generation == other.generation &&
+               operand_a == other.operand_a && operand_b == other.operand_b && operand_c == other.operand_c;
+    }
+};
+
+struct grow_key_hash_t {
+    size_t operator()(const grow_key_t& key) const {
+        size_t h = hash<int>()(key.op * 131 + key.generation);
+        h ^= hash<BaseType*>()(key.operand_a) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= hash<BaseType*>()(key.operand_b) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= hash<BaseType*>()(key.operand_c) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+class programBank;
+
+/*
+ Program arena: owns the programs allocated outside a program bank, e.g. by a
+ search once the bank is full, or the if-then-else nodes built by unification.
+ A bounded arena makes a runaway search stop, and deleting the arena discards
+ everything a timed-out search allocated. It also keeps alive the banks its
+ programs were grown from.
+ */
+class programArena {
+public:
+    programArena(size_t capacity = 0);
+    ~programArena();
+    
+    /* Take ownership of a program, false if the arena is full */
+    bool add(BaseType* program);
+    
+    /* Take ownership of all programs of another arena */
+    void adopt(programArena* other);
+    
+    /* Keep a bank alive as long as the arena, its programs may be operands of ours */
+    void keep_bank(shared_ptr<programBank> bank);
+    
+    size_t size();
+
+private:
+    vector<BaseType*> _programs;
+    set<shared_ptr<programBank>> _banks;
+    size_t _capacity;   // 0 for unbounded
+    mutex _mutex;
+};
+
+/*
+ Program bank: an enumeration cache shared by every bottomUpSearch using the
+ same language configuration. It owns the leaf programs (vars and constants)
+ and remembers the outcome of growing "op a b c" at a given generation, so a
+ search over another example subset re-evaluates the cached skeletons instead
+ of re-checking the grow rules and re-allocating the programs.
+ The cache is independent of input-output examples: the grow rules only look
+ at the operands. Banks are shared between threads.
+ The registry keeps the recently used banks up to a total number of programs,
+ so long-running servers and batches do not grow without bound. An evicted
+ bank is freed once no search or arena holds it.
+ */
+class programBank {
+public:
+    programBank(string language_key);
+    ~programBank();
+    
+    /* Get the bank of a language configuration, created on first use */
+    static shared_ptr<programBank> get_bank(string language_key);
+    
+    /* Shared leaves */
+    Var* get_var(string name);
+    Num* get_num(int value);
+    
+    /* Look up the grown program of "op a b c" at a generation, nullptr means rejected */
+    bool lookup(string op, BaseType* operand_a, BaseType* operand_b, BaseType* operand_c, int program_generation, BaseType** program);
+    
+    /* Record a grown program, returns the program kept by the bank (the one recorded
+       first if another search raced us), or nullptr if the bank is full and the caller keeps ownership */
+    BaseType* record(string op, BaseType* operand_a, BaseType* operand_b, BaseType* operand_c, int program_generation, BaseType* program);
+    
+    /* Grown programs recorded */
+    size_t size();
+    
+    /* Dumping function */
+    void dump_statistics();
+
+private:
+    inline int get_op_id(string op);
+    
+    string _language_key;
+    
+    map<string, Var*> _vars;
+    map<int, Num*> _nums;
+    
+    unordered_map<grow_key_t, BaseType*, grow_key_hash_t> _grown_programs;
+    map<int, size_t> _num_of_skeletons_per_generation;
+    size_t _capacity = 1 << 21;
+    
+    /* grown programs recorded by all the banks of the registry */
+    static const size_t _registry_capacity = 1 << 22;
+    
+    shared_mutex _mutex;
+    
+    /* Statistics */
+    atomic<long> _num_of_lookups;
+    atomic<long> _num_of_hits;
+};
+
+#endif
@@ -0,0 +1,131 @@
+#include "resultCache.hpp"
+/******************************************
+    Constructor
+ */
+resultCache::resultCache(string cache_file) {
+    _cache_file = cache_file;
+    
+    /* later lines win, except that a failure never hides a program found */
+    ifstream in(cache_file);
+    string line;
+    while (getline(in, line)) {
+        istringstream cache_line(line);
+        string hash, status;
+        cached_result_t result;
+        if (!(cache_line >> hash >> result.term_budget >> result.predicate_budget >> result.deadline >> status)) continue;
+        if (status == "found") {
+            getline(cache_line >> ws, result.program);
+            if (result.program == "") continue;
+        } else if (status != "not_found") {
+            continue;
+        }
+        
+        auto it = _results.find(hash);
+        if (it != _results.end() && it->second.program != "" && result.program == "") continue;
+        _results[hash] = result;
+    }
+}
+
+/******************************************
+    Hash
+ */
+uint64_t resultCache::fnv1a(const string& text, uint64_t h) {
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+string resultCache::problem_hash(synthesis_config_t config, input_outputs_t input_outputs) {
+    /* the defaults and the variables completed the way synthesize does */
+    language_configuration(&config.language, input_outputs);
+    language_config_t& language = config.language;
+    
+    ostringstream text;
+    auto dump_list = [&text](string name, const vector<string>& list) {
+        text << name;
+        for (auto item : list) text << " " << item;
+        text << "\n";
+    };
+    text << "bench " << config.bench_name << " ref " << config.ref_id << "\n";
+    text << "depthpred " << language.depth_bound_for_predicate << " depthterm " << language.depth_bound_for_term << "\n";
+    dump_list("intopspred", language.int_ops_for_predicate);
+    dump_list("boolopspred", language.bool_ops_for_predicate);
+    dump_list("varspred", language.vars_in_predicate);
+    dump_list("constantspred", language.constants_in_predicate);
+    dump_list("intopsterm", language.int_ops_for_term);
+    dump_list("boolopsterm", language.bool_ops_for_term);
+    dump_list("varsterm", language.vars_in_term);
+    dump_list("constantsterm", language.constants_in_term);
+    dump_list("rules", language.rules_to_apply);
+    dump_list("splits", config.split_strategies);
+    text << "growing " << config.num_growing_speed << " " << config.num_growing_upperbound << "\n";
+    text << "backend " << config.predicate_backend << " unification " << config.unification_engine << "\n";
+    if (config.sampling_rate < 1) {
+        text << "sampling " << config.sampling_rate << " " << config.sampling_strata << " " << config.is_progressive_sampling << " " << config.sampling_seed << "\n";
+    }
+    
+    /* examples in a canonical order, duplicates dropped */
+    vector<string> examples;
+    for (auto ioe : input_outputs) {
+        string example;
+        for (auto var_value : ioe) example += var_value.first + " " + to_string(var_value.second) + " ";
+        examples.push_back(example);
+    }
+    sort(examples.begin(), examples.end());
+    examples.erase(unique(examples.begin(), examples.end()), examples.end());
+    for (auto example : examples) text << example << "\n";
+    
+    /* two independent 64 bit hashes of the text */
+    ostringstream hash;
+    hash << hex << setfill('0') << setw(16) << fnv1a(text.str(), 0xcbf29ce484222325ULL)
+                                << setw(16) << fnv1a(text.str(), 0x84222325cbf29ce4ULL);
+    return hash.str();
+}
+
+/******************************************
+    Lookup and record
+ */
+bool resultCache::lookup(const string& hash, const synthesis_config_t& config, string* program) {
+    unique_lock<mutex> lock(_mutex);
+    auto it = _results.find(hash);
+    if (it == _results.end()) return false;
+    
+    cached_result_t& result = it->second;
+    if (result.program != "") {
+        *program = result.program;
+        return true;
+    }
+    
+    /* a failure is retried once any budget grew */
+    if (config.search_time_for_terms_in_seconds > result.term_budget) return false;
+    if (config.search_time_for_predicates_in_seconds > result.predicate_budget) return false;
+    if (result.deadline != -1 && (config.deadline_in_seconds <= 0 || config.deadline_in_seconds > result.deadline)) return false;
+    *program = "";
+    return true;
+}
+
+void resultCache::record(const string& hash, const synthesis_config_t& config, string program) {
+    if (program == "" && (config.anytime_deadline_in_seconds > 0 || config.checkpoint_file != "")) return;
+    
+    cached_result_t result;
+    result.program = program;
+    result.term_budget = config.search_time_for_terms_in_seconds;
+    result.predicate_budget = config.search_time_for_predicates_in_seconds;
+    result.deadline = (config.deadline_in_seconds > 0) ? config.deadline_in_seconds : -1;
+    
+    ostringstream line;
+    line << hash << " " << result.term_budget << " " << result.predicate_budget << " " << result.deadline << " "
+         << ((program != "") ? "found " + program : "not_found") << "\n";
+    
+    /* one write per line, so that processes of a sweep can append to the same log */
+    unique_lock<mutex> lock(_mutex);
+    ofstream out(_cache_file, ios::app);
+    if (!out.is_open()) throw runtime_error("Can not write result cache " + _cache_file);
+    out << line.str() << flush;
+    
+    auto it = _results.find(hash);
+    if (it != _results.end() && it->second.program != "" && program == "") return;
+    _results[hash] = result;
+}
@@ -0,0 +1,58 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include "synthesizer.hpp"
+#include "typeDef.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/*
+ Persistent result cache: an append-only log of synthesis outcomes keyed by
+ the content hash of the problem, so re-running a sweep only synthesizes the
+ problems whose examples or configuration changed.
+ Programs found are reused whatever the budgets. Failures are reused while
+ the budgets they failed within are at least the current ones.
+ 
+ Log lines: hash term_budget predicate_budget deadline found program
+            hash term_budget predicate_budget deadline not_found
+ */
+class resultCache {
+public:
+    resultCache(string cache_file);
+    
+    /* hash of the sorted examples and of everything in the configuration the program depends on,
+       the budgets excepted */
+    static string problem_hash(synthesis_config_t config, input_outputs_t input_outputs);
+    
+    /* true if the outcome is known: the program, or "" for a failure within at least the current budgets */
+    bool lookup(const string& hash, const synthesis_config_t& config, string* program);
+    
+    /* append an outcome to the log, failures of anytime or checkpointed runs depend on more than the budgets */
+    void record(const string& hash, const synthesis_config_t& config, string program);
+
+private:
+    struct cached_result_t {
+        string program;
+        int term_budget;
+        int predicate_budget;
+        int deadline;   // -1 for none
+    };
+    
+    static uint64_t fnv1a(const string& text, uint64_t h);
+    
+    string _cache_file;
+    unordered_map<string, cached_result_t> _results;
+    mutex _mutex;
+};
+
+#endif
@@ -1,30 +1,124 @@
 #include "sampler.hpp"
 
-sampler::sampler(double samplingRate) {
+sampler::sampler(double samplingRate, unsigned seed) {
     _samplingRate = samplingRate;
+    _generator.seed(seed);
 }
 
-vector<map<string, int> > sampler::uniformSampling(vector<map<string, int> > inputOutputs) {
-    return inputOutputs;
+vector<int> sampler::sampleIds(exampleTable* table, string strata) {
+    int numOfStrata = 1;
+    if (strata == "RANDOM") {
+        return stratifiedSampleIds(vector<int>(table->size(), 0), numOfStrata);
+    } else if (strata == "GRID") {
+        vector<int> gridStratum = gridStrata(table, &numOfStrata);
+        return stratifiedSampleIds(gridStratum, numOfStrata);
+    } else if (strata == "OUTPUT") {
+        vector<int> outputStratum = outputStrata(table, &numOfStrata);
+        return stratifiedSampleIds(outputStratum, numOfStrata);
+    }
+    throw runtime_error("Unknown sampling strata " + strata);
+}
+
+vector<int> sampler::pickIds(vector<int> ids, int count) {
+    count = min(count, (int)ids.size());
+    for (int i = 0; i < count; i++) {
+        uniform_int_distribution<int> pick(i, ids.size() - 1);
+        swap(ids[i], ids[pick(_generator)]);
+    }
+    ids.resize(count);
+    sort(ids.begin(), ids.end());
+    return ids;
 }
 
-vector<map<string, int> > sampler::randomSampling(vector<map<string, int> > inputOutputs) {
+/******************************************
+    Strata
+ */
+vector<int> sampler::gridStrata(exampleTable* table, int* numOfStrata) {
+    int numOfExamples = table->size();
+    vector<int> strata(numOfExamples, 0);
+    *numOfStrata = 1;
+    if (numOfExamples == 0) return strata;
     
-    int numOfSamples = _samplingRate * inputOutputs.size();
-    set<int> record;
+    vector<int> boundColumns;
+    vector<string> vars = table->get_vars();
+    for (int column = 0; column < vars.size(); column++) {
+        if (vars[column].find("b") != string::npos) boundColumns.push_back(column);
+    }
+    if (boundColumns.empty()) return strata;
+    
+    /* as many cells as samples, the same number of blocks of value ranks along every bound */
+    int numOfSamples = max(1, (int)(_samplingRate * numOfExamples));
+    int cellsPerBound = max(1, (int)floor(pow(numOfSamples, 1.0 / boundColumns.size()) + 1e-9));
     
-    for (int i = 0; i < numOfSamples; i++) {
-        int inputOutputsId = rand() % inputOutputs.size();
-        while (find(record.begin(), record.end(), inputOutputsId) != record.end()) {
-            inputOutputsId = rand() % inputOutputs.size();
+    for (auto column : boundColumns) {
+        unordered_map<int, int> rankOfValue;
+        for (int i = 0; i < numOfExamples; i++) rankOfValue[table->get_value(column, i)] = 0;
+        vector<int> distinctValues;
+        for (auto &valueRank : rankOfValue) distinctValues.push_back(valueRank.first);
+        sort(distinctValues.begin(), distinctValues.end());
+        for (int rank = 0; rank < distinctValues.size(); rank++) rankOfValue[distinctValues[rank]] = rank;
+        
+        for (int i = 0; i < numOfExamples; i++) {
+            int block = (long)rankOfValue[table->get_value(column, i)] * cellsPerBound / distinctValues.size();
+            strata[i] = strata[i] * cellsPerBound + block;
+        }
+        *numOfStrata *= cellsPerBound;
+    }
+    return strata;
+}
+
+vector<int> sampler::outputStrata(exampleTable* table, int* numOfStrata) {
+    int numOfExamples = table->size();
+    unordered_map<int, int> stratumOfOutput;
+    for (int i = 0; i < numOfExamples; i++) {
+        int output = table->get_output(i);
+        if (stratumOfOutput.find(output) == stratumOfOutput.end()) {
+            int stratum = stratumOfOutput.size();
+            stratumOfOutput[output] = stratum;
         }
-        record.insert(inputOutputsId);
     }
     
-    vector<map<string, int> > inputOutputsSampled;
-    for (auto it = record.begin(), eit = record.end(); it != eit; ++it) {
-        inputOutputsSampled.push_back(inputOutputs[*it]);
+    /* too many output levels to keep one example of each, zero and non zero outputs only */
+    int numOfSamples = max(1, (int)(_samplingRate * numOfExamples));
+    vector<int> strata(numOfExamples);
+    if (stratumOfOutput.size() > numOfSamples) {
+        for (int i = 0; i < numOfExamples; i++) strata[i] = (table->get_output(i) != 0);
+        *numOfStrata = 2;
+    } else {
+        for (int i = 0; i < numOfExamples; i++) strata[i] = stratumOfOutput[table->get_output(i)];
+        *numOfStrata = max(1, (int)stratumOfOutput.size());
+    }
+    return strata;
+}
+
+/******************************************
+    Selection
+ */
+vector<int> sampler::stratifiedSampleIds(const vector<int>& strata, int numOfStrata) {
+    /* bucket the rows by stratum */
+    vector<int> offsets(numOfStrata + 1, 0);
+    for (auto stratum : strata) offsets[stratum + 1]++;
+    for (int s = 0; s < numOfStrata; s++) offsets[s + 1] += offsets[s];
+    vector<int> buckets(strata.size());
+    vector<int> next(offsets.begin(), offsets.end() - 1);
+    for (int i = 0; i < strata.size(); i++) buckets[next[strata[i]]++] = i;
+    
+    /* a partial shuffle of every bucket */
+    vector<bool> isSampled(strata.size(), false);
+    for (int s = 0; s < numOfStrata; s++) {
+        int size = offsets[s + 1] - offsets[s];
+        if (size == 0) continue;
+        int quota = min(size, max(1, (int)round(_samplingRate * size)));
+        for (int i = 0; i < quota; i++) {
+            uniform_int_distribution<int> pick(offsets[s] + i, offsets[s + 1] - 1);
+            swap(buckets[offsets[s] + i], buckets[pick(_generator)]);
+            isSampled[buckets[offsets[s] + i]] = true;
+        }
     }
     
-    return inputOutputsSampled;
+    vector<int> ids;
+    for (int i = 0; i < strata.size(); i++) {
+        if (isSampled[i]) ids.push_back(i);
+    }
+    return ids;
 }
@@ -1,21 +1,43 @@
 #ifndef SAMPLER_H
 #define SAMPLER_H
 
+#include "exampleTable.hpp"
 #include <string>
 #include <map>
 #include <set>
 #include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
 #include <vector>
 using namespace std;
 
+/*
+ Sampling of input-output examples, so large IOE files are synthesized on a
+ fraction of their rows. Stratified samplings split the examples in strata
+ and keep the sampling rate of every stratum, at least one example each.
+ Selection is linear in the examples. Every sampler draws from a generator
+ of its own seeded at construction, so one sampler per thread gives the same
+ samples whatever the scheduling.
+ */
 class sampler {
 public:
-    sampler(double samplingRate);
-    vector<map<string, int> > uniformSampling(vector<map<string, int> > inputOutputs);
-    vector<map<string, int> > randomSampling(vector<map<string, int> > inputOutputs);
+    sampler(double samplingRate, unsigned seed = 0);
     
+    /* Rows of a sample, sorted: strata RANDOM, GRID or OUTPUT */
+    vector<int> sampleIds(exampleTable* table, string strata);
+    
+    /* Pick count ids at random, sorted */
+    vector<int> pickIds(vector<int> ids, int count);
+
 private:
+    vector<int> gridStrata(exampleTable* table, int* numOfStrata);
+    vector<int> outputStrata(exampleTable* table, int* numOfStrata);
+    vector<int> stratifiedSampleIds(const vector<int>& strata, int numOfStrata);
+    
     double _samplingRate;
+    mt19937 _generator;
 };
 
 #endif
@@ -0,0 +1,58 @@
+#include "searchControl.hpp"
+/******************************************
+    Constructor
+ */
+searchControl::searchControl(int time_bound_in_seconds, shared_ptr<searchControl> parent) {
+    _start = chrono::steady_clock::now();
+    _deadline = _start + chrono::seconds(time_bound_in_seconds);
+    _cancelled = false;
+    _parent = parent;
+}
+
+searchControl::searchControl(shared_ptr<searchControl> parent) {
+    _start = chrono::steady_clock::now();
+    _deadline = chrono::steady_clock::time_point::max();
+    _cancelled = false;
+    _parent = parent;
+}
+
+void searchControl::cancel() {
+    _cancelled = true;
+}
+
+bool searchControl::is_cancelled() {
+    if (_cancelled) return true;
+    if (_parent != nullptr) return _parent->is_cancelled();
+    return false;
+}
+
+bool searchControl::is_stopped() {
+    if (_cancelled) return true;
+    if (chrono::steady_clock::now() >= _deadline) return true;
+    if (_parent != nullptr) return _parent->is_stopped();
+    return false;
+}
+
+double searchControl::get_elapsed_seconds() {
+    return chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+}
+
+/******************************************
+    Search profile
+ */
+void search_profile_t::record_bank_size(bool is_predicate, int generation, size_t size) {
+    vector<size_t>& bank_sizes = is_predicate ? predicate_bank_sizes : term_bank_sizes;
+    if (generation < 1) return;
+    if (bank_sizes.size() < generation) bank_sizes.resize(generation, 0);
+    bank_sizes[generation - 1] = max(bank_sizes[generation - 1], size);
+}
+
+void search_profile_t::merge(const search_profile_t& other) {
+    term_search_seconds += other.term_search_seconds;
+    predicate_search_seconds += other.predicate_search_seconds;
+    grow_seconds += other.grow_seconds;
+    eliminate_seconds += other.eliminate_seconds;
+    evaluate_seconds += other.evaluate_seconds;
+    for (int i = 0; i < other.term_bank_sizes.size(); i++) record_bank_size(false, i + 1, other.term_bank_sizes[i]);
+    for (int i = 0; i < other.predicate_bank_sizes.size(); i++) record_bank_size(true, i + 1, other.predicate_bank_sizes[i]);
+}
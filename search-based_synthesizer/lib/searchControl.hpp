@@ -0,0 +1,69 @@
+#ifndef SEARCHCONTROL_H
+#define SEARCHCONTROL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+/*
+ Cooperative deadline and cancellation of one search.
+ A search is stopped when its own deadline passes, or when it or any of its
+ parents is cancelled. Searches poll is_stopped() inside their loops.
+ */
+class searchControl {
+public:
+    searchControl(int time_bound_in_seconds, shared_ptr<searchControl> parent = nullptr);
+    /* cancellation scope without a deadline of its own */
+    searchControl(shared_ptr<searchControl> parent);
+    
+    void cancel();
+    bool is_cancelled();
+    bool is_stopped();
+    
+    double get_elapsed_seconds();
+
+private:
+    chrono::steady_clock::time_point _start;
+    chrono::steady_clock::time_point _deadline;
+    atomic<bool> _cancelled;
+    shared_ptr<searchControl> _parent;
+};
+
+/* Progress of a synthesis, reported every time one of its searches finishes */
+struct search_progress_t {
+    int num_of_searches = 0;        // finished searches
+    int num_of_found = 0;           // of which found a program
+    double elapsed_seconds = 0;
+};
+
+typedef function<void(const search_progress_t&)> progress_callback_t;
+
+/* Where the bottom-up searches of a synthesis spent their time, summed over the search threads */
+struct search_profile_t {
+    double term_search_seconds = 0;
+    double predicate_search_seconds = 0;
+    double grow_seconds = 0;
+    double eliminate_seconds = 0;
+    double evaluate_seconds = 0;        // correctness checks of the new programs
+    
+    /* programs kept after every generation, the largest over the searches */
+    vector<size_t> term_bank_sizes;
+    vector<size_t> predicate_bank_sizes;
+    
+    void record_bank_size(bool is_predicate, int generation, size_t size);
+    void merge(const search_profile_t& other);
+};
+
+/* Shape of the tree of a unification, split nodes and the leaves searched for terms */
+struct unification_shape_t {
+    int num_of_nodes = 0;
+    int num_of_leaves = 0;
+    int depth = 0;
+};
+
+#endif
@@ -0,0 +1,371 @@
+#include "splitStrategy.hpp"
+/******************************************
+    Lt atom library
+ */
+ltAtomLibrary::ltAtomLibrary(int num_of_examples) {
+    _num_of_examples = num_of_examples;
+}
+
+void ltAtomLibrary::add_atom(vector<bool> values) {
+    if (values.size() != _num_of_examples) throw runtime_error("Atom values do not match the examples");
+    
+    /* an atom and its complement split the examples the same way */
+    vector<bool> complement = values;
+    complement.flip();
+    if (_seen_values.find(values) != _seen_values.end() || _seen_values.find(complement) != _seen_values.end()) return;
+    _seen_values.insert(values);
+    _values.push_back(values);
+}
+
+int ltAtomLibrary::size() {
+    return _values.size();
+}
+
+bool ltAtomLibrary::get_value(int atom_id, int example_id) {
+    return _values[atom_id][example_id];
+}
+
+int ltAtomLibrary::count_agreement(const vector<bool>& target, const vector<bool>& prediction) {
+    int cnt = 0;
+    for (int i = 0; i < target.size(); i++) {
+        if (target[i] == prediction[i]) cnt++;
+    }
+    return cnt;
+}
+
+double ltAtomLibrary::score_separability(const vector<int>& example_ids, const vector<bool>& is_left) {
+    int num_of_examples = example_ids.size();
+    if (num_of_examples == 0) return 1.0;
+    
+    int best = 0;
+    for (int polarity = 0; polarity < 2; polarity++) {
+        vector<bool> target = is_left;
+        if (polarity == 1) target.flip();
+        
+        /* best single literal */
+        int first_atom = -1;
+        int first_agreement = count_agreement(target, vector<bool>(num_of_examples, true));
+        vector<bool> first_prediction(num_of_examples, true);
+        for (int atom = 0; atom < _values.size(); atom++) {
+            for (int negated = 0; negated < 2; negated++) {
+                vector<bool> prediction(num_of_examples);
+                for (int i = 0; i < num_of_examples; i++) prediction[i] = (_values[atom][example_ids[i]] != negated);
+                int agreement = count_agreement(target, prediction);
+                if (agreement > first_agreement) {
+                    first_agreement = agreement;
+                    first_atom = atom;
+                    first_prediction = prediction;
+                }
+            }
+        }
+        best = max(best, first_agreement);
+        if (first_atom == -1 || best == num_of_examples) continue;
+        
+        /* best second literal conjoined with it */
+        for (int atom = 0; atom < _values.size(); atom++) {
+            for (int negated = 0; negated < 2; negated++) {
+                vector<bool> prediction(num_of_examples);
+                for (int i = 0; i < num_of_examples; i++) prediction[i] = first_prediction[i] && (_values[atom][example_ids[i]] != negated);
+                best = max(best, count_agreement(target, prediction));
+            }
+        }
+    }
+    return (double)best / num_of_examples;
+}
+
+/******************************************
+    Split strategies
+ */
+splitStrategy* splitStrategy::create(string name) {
+    if (name == "HALF") return new halfSplitStrategy();
+    if (name == "FREQUENT") return new frequentSplitStrategy();
+    if (name == "REGION") return new regionSplitStrategy(false);
+    if (name == "LINEARREGION") return new regionSplitStrategy(true);
+    if (name == "SEPARABLE") return new separableSplitStrategy();
+    throw runtime_error("Unknown split strategy " + name);
+}
+
+bool halfSplitStrategy::split(exampleTable* table, ltAtomLibrary*, const vector<int>& example_ids, example_split_t* split) {
+    vector<int> example_outputs = table->get_outputs(example_ids);
+    vector<int> outputs = example_outputs;
+    if (outputs.size() < 2) {
+        return false;
+    }
+    
+    sort(outputs.begin(), outputs.end());
+    
+    bool splitFlag = false;
+    bool allSameValue = false;
+    size_t half_size = outputs.size() / 2;
+    
+    /* Check if there is 0 in outputs. If there is,
+     (1) split 0 into a group and others in the other group
+     (2) if all 0, split half and half
+     */
+    if (outputs.front() == 0) {
+        if (outputs.back() == 0) {
+            half_size = outputs.size() / 2;
+            splitFlag = true;
+            allSameValue = true;
+        } else {
+            half_size = 0;
+            while(half_size < outputs.size() && outputs[half_size] == 0) {
+                half_size++;
+            }
+            splitFlag = true;
+        }
+    }
+    
+    /* Find split size, split into half size first, try grow first half */
+    if (splitFlag == false) {
+        half_size = outputs.size() / 2;
+        while (half_size >= 1 && half_size < outputs.size() && outputs[half_size - 1] == outputs[half_size]) {
+            half_size++;
+        }
+        if (half_size != 0 && half_size != outputs.size()) {
+            splitFlag = true;
+        }
+    }
+    
+    /* if grow first half failed, try grow second half */
+    if (splitFlag == false) {
+        half_size = outputs.size() / 2;
+        while (half_size >= 1 && half_size < outputs.size() && outputs[half_size - 1] == outputs[half_size]) {
+            half_size--;
+        }
+        if (half_size != 0 && half_size != outputs.size()) {
+            splitFlag = true;
+        }
+    }
+    
+    /* all same value but not 0 */
+    if (splitFlag == false) {
+        half_size = outputs.size() / 2;
+        allSameValue = true;
+    }
+    
+    /* found split size, do the split */
+    split->strategy = _name;
+    if (allSameValue == true) {
+        for (int i = 0; i < half_size; i++) {
+            split->left_example_ids.push_back(example_ids[i]);
+        }
+        for (int i = half_size; i < example_ids.size(); i++) {
+            split->right_example_ids.push_back(example_ids[i]);
+        }
+    } else {
+        /* the predicate separates the lower outputs from the higher ones */
+        for (int i = 0; i < example_ids.size(); i++) {
+            if (example_outputs[i] <= outputs[half_size-1]) {
+                split->left_example_ids.push_back(example_ids[i]);
+                split->labels.push_back(true);
+            } else {
+                split->right_example_ids.push_back(example_ids[i]);
+                split->labels.push_back(false);
+            }
+        }
+    }
+    return true;
+}
+
+bool frequentSplitStrategy::split(exampleTable* table, ltAtomLibrary*, const vector<int>& example_ids, example_split_t* split) {
+    vector<int> example_outputs = table->get_outputs(example_ids);
+    vector<int> outputs = example_outputs;
+    if (outputs.size() < 2) {
+        return false;
+    }
+    
+    sort(outputs.begin(), outputs.end());
+    
+    /* find the most frequent appearing output */
+    int maxCnt = 0;
+    int mostFreqOut = -1;
+    int currCnt = 0;
+    int prevOut = -7; // some number will never appear in the output
+    for (auto out : outputs) {
+        if (out != prevOut) {
+            currCnt = 0;
+        }
+        currCnt++;
+        if (currCnt > maxCnt) {
+            maxCnt = currCnt;
+            mostFreqOut = out;
+        }
+        prevOut = out;
+    }
+    
+    /* do the split */
+    split->strategy = _name;
+    if (maxCnt == 1) {
+        split->left_example_ids.push_back(example_ids.front());
+        for (int i = 1; i < example_ids.size(); i++) {
+            split->right_example_ids.push_back(example_ids[i]);
+        }
+    } else {
+        for (int i = 0; i < example_ids.size(); i++) {
+            if (example_outputs[i] == mostFreqOut) {
+                split->left_example_ids.push_back(example_ids[i]);
+            } else {
+                split->right_example_ids.push_back(example_ids[i]);
+            }
+        }
+    }
+    return true;
+}
+
+bool regionSplitStrategy::split(exampleTable* table, ltAtomLibrary*, const vector<int>& example_ids, example_split_t* split) {
+    int num_of_examples = example_ids.size();
+    int num_of_dims = table->get_vars().size();
+    if (num_of_examples < 2) {
+        return false;
+    }
+    
+    /* grid coordinates of the examples and the sorted values on every axis */
+    vector<vector<int>> coordinates(num_of_examples, vector<int>(num_of_dims));
+    vector<vector<int>> axes(num_of_dims);
+    map<vector<int>, int> position;
+    for (int i = 0; i < num_of_examples; i++) {
+        for (int dim = 0; dim < num_of_dims; dim++) {
+            coordinates[i][dim] = table->get_value(dim, example_ids[i]);
+            axes[dim].push_back(coordinates[i][dim]);
+        }
+        position.insert(make_pair(coordinates[i], i));
+    }
+    for (auto &axis : axes) {
+        sort(axis.begin(), axis.end());
+        axis.erase(unique(axis.begin(), axis.end()), axis.end());
+    }
+    vector<int> outputs = table->get_outputs(example_ids);
+    
+    /* grow a region from every example not yet in one, keep the largest */
+    vector<bool> is_visited(num_of_examples, false);
+    vector<int> largest_region;
+    for (int seed = 0; seed < num_of_examples; seed++) {
+        if (is_visited[seed]) continue;
+        
+        vector<int> region = {seed};
+        is_visited[seed] = true;
+        
+        /* slope of the outputs along every axis, as output step over coordinate step */
+        vector<bool> has_slope(num_of_dims, false);
+        vector<long long> slope_output(num_of_dims, 0);
+        vector<long long> slope_coordinate(num_of_dims, 1);
+        
+        queue<int> frontier;
+        frontier.push(seed);
+        while (!frontier.empty()) {
+            int current = frontier.front();
+            frontier.pop();
+            for (int dim = 0; dim < num_of_dims; dim++) {
+                auto it = lower_bound(axes[dim].begin(), axes[dim].end(), coordinates[current][dim]);
+                for (int step = -1; step <= 1; step += 2) {
+                    if (step == -1 && it == axes[dim].begin()) continue;
+                    if (step == 1 && it + 1 == axes[dim].end()) continue;
+                    vector<int> neighbour_coordinates = coordinates[current];
+                    neighbour_coordinates[dim] = *(it + step);
+                    auto neighbour_it = position.find(neighbour_coordinates);
+                    if (neighbour_it == position.end()) continue;
+                    int neighbour = neighbour_it->second;
+                    if (is_visited[neighbour]) continue;
+                    
+                    long long output_step = (long long)outputs[neighbour] - outputs[current];
+                    long long coordinate_step = (long long)neighbour_coordinates[dim] - coordinates[current][dim];
+                    bool is_consistent = (output_step == 0);
+                    if (_is_linear) {
+                        if (!has_slope[dim]) {
+                            has_slope[dim] = true;
+                            slope_output[dim] = output_step;
+                            slope_coordinate[dim] = coordinate_step;
+                            is_consistent = true;
+                        } else {
+                            is_consistent = (output_step * slope_coordinate[dim] == slope_output[dim] * coordinate_step);
+                        }
+                    }
+                    if (!is_consistent) continue;
+                    
+                    is_visited[neighbour] = true;
+                    region.push_back(neighbour);
+                    frontier.push(neighbour);
+                }
+            }
+        }
+        if (region.size() > largest_region.size()) {
+            largest_region = region;
+        }
+    }
+    
+    /* one region covering everything is left to the term search */
+    if (largest_region.size() == num_of_examples) {
+        return false;
+    }
+    
+    vector<bool> is_left(num_of_examples, false);
+    for (auto i : largest_region) is_left[i] = true;
+    split->strategy = _name;
+    for (int i = 0; i < num_of_examples; i++) {
+        if (is_left[i]) {
+            split->left_example_ids.push_back(example_ids[i]);
+        } else {
+            split->right_example_ids.push_back(example_ids[i]);
+        }
+        split->labels.push_back(is_left[i]);
+    }
+    return true;
+}
+
+bool separableSplitStrategy::split(exampleTable* table, ltAtomLibrary* atoms, const vector<int>& example_ids, example_split_t* split) {
+    int num_of_examples = example_ids.size();
+    if (num_of_examples < 2 || atoms == nullptr) {
+        return false;
+    }
+    vector<int> outputs = table->get_outputs(example_ids);
+    
+    /* count the examples sharing the most frequent output on each side of every atom */
+    int best_atom = -1;
+    int best_purity = -1;
+    int best_balance = -1;
+    for (int atom = 0; atom < atoms->size(); atom++) {
+        map<int, int> true_counts;
+        map<int, int> false_counts;
+        int num_of_true = 0;
+        for (int i = 0; i < num_of_examples; i++) {
+            if (atoms->get_value(atom, example_ids[i])) {
+                true_counts[outputs[i]]++;
+                num_of_true++;
+            } else {
+                false_counts[outputs[i]]++;
+            }
+        }
+        if (num_of_true == 0 || num_of_true == num_of_examples) continue;
+        
+        int purity = 0;
+        int max_count = 0;
+        for (auto output_count : true_counts) max_count = max(max_count, output_count.second);
+        purity += max_count;
+        max_count = 0;
+        for (auto output_count : false_counts) max_count = max(max_count, output_count.second);
+        purity += max_count;
+        
+        int balance = min(num_of_true, num_of_examples - num_of_true);
+        if (purity > best_purity || (purity == best_purity && balance > best_balance)) {
+            best_atom = atom;
+            best_purity = purity;
+            best_balance = balance;
+        }
+    }
+    if (best_atom == -1) {
+        return false;
+    }
+    
+    split->strategy = _name;
+    for (int i = 0; i < num_of_examples; i++) {
+        bool value = atoms->get_value(best_atom, example_ids[i]);
+        if (value) {
+            split->left_example_ids.push_back(example_ids[i]);
+        } else {
+            split->right_example_ids.push_back(example_ids[i]);
+        }
+        split->labels.push_back(value);
+    }
+    return true;
+}
@@ -0,0 +1,104 @@
+#ifndef SPLITSTRATEGY_H
+#define SPLITSTRATEGY_H
+
+#include "exampleTable.hpp"
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//#define DEBUG
+
+/* A proposed split of the examples of a node */
+struct example_split_t {
+    string strategy;
+    vector<int> left_example_ids;
+    vector<int> right_example_ids;
+    vector<int> labels;             // predicate labels in node order, empty to keep the outputs
+    double score = 0.0;             // separability estimated with cheap Lt atoms, in [0.5, 1]
+};
+
+/*
+ Truth values of cheap Lt atoms on every row of an example table. Used to
+ propose splits and to rank them before paying for a predicate search.
+ */
+class ltAtomLibrary {
+public:
+    ltAtomLibrary(int num_of_examples);
+    
+    /* add an atom by its truth value on every row, atoms splitting the rows alike are dropped */
+    void add_atom(vector<bool> values);
+    int size();
+    bool get_value(int atom_id, int example_id);
+    
+    /* best accuracy of a conjunction of at most two atoms, or of its negation, at telling left from right */
+    double score_separability(const vector<int>& example_ids, const vector<bool>& is_left);
+
+private:
+    int count_agreement(const vector<bool>& target, const vector<bool>& prediction);
+    
+    int _num_of_examples;
+    vector<vector<bool>> _values;
+    set<vector<bool>> _seen_values;
+};
+
+/*
+ Split strategy: proposes how the examples of a node are divided between the
+ then- and else-branch of an if-then-else.
+ */
+class splitStrategy {
+public:
+    virtual ~splitStrategy() {}
+    
+    /* propose a split of the given examples, false if the strategy has none */
+    virtual bool split(exampleTable* table, ltAtomLibrary* atoms, const vector<int>& example_ids, example_split_t* split) = 0;
+    
+    string get_name() { return _name; }
+    
+    /* HALF, FREQUENT, REGION, LINEARREGION or SEPARABLE */
+    static splitStrategy* create(string name);
+
+protected:
+    string _name;
+};
+
+/* Split outputs half and half, examples with zero output first */
+class halfSplitStrategy : public splitStrategy {
+public:
+    halfSplitStrategy() { _name = "HALF"; }
+    bool split(exampleTable* table, ltAtomLibrary* atoms, const vector<int>& example_ids, example_split_t* split);
+};
+
+/* Split the most frequent output from the others */
+class frequentSplitStrategy : public splitStrategy {
+public:
+    frequentSplitStrategy() { _name = "FREQUENT"; }
+    bool split(exampleTable* table, ltAtomLibrary* atoms, const vector<int>& example_ids, example_split_t* split);
+};
+
+/*
+ Split the largest connected region of the bound grid whose outputs are equal,
+ or linear along every grid dimension, from the other examples.
+ */
+class regionSplitStrategy : public splitStrategy {
+public:
+    regionSplitStrategy(bool is_linear) : _is_linear(is_linear) { _name = is_linear ? "LINEARREGION" : "REGION"; }
+    bool split(exampleTable* table, ltAtomLibrary* atoms, const vector<int>& example_ids, example_split_t* split);
+
+private:
+    bool _is_linear;
+};
+
+/* Split along the cheap Lt atom whose sides have the most uniform outputs */
+class separableSplitStrategy : public splitStrategy {
+public:
+    separableSplitStrategy() { _name = "SEPARABLE"; }
+    bool split(exampleTable* table, ltAtomLibrary* atoms, const vector<int>& example_ids, example_split_t* split);
+};
+
+#endif
@@ -0,0 +1,206 @@
+#include "synthesisServer.hpp"
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+/******************************************
+    Constructor
+ */
+synthesisServer::synthesisServer(string socket_path, synthesis_config_t config, request_parser_t request_parser, int max_requests) {
+    _socket_path = socket_path;
+    _config = config;
+    _request_parser = request_parser;
+    _max_requests = max_requests;
+    _num_of_requests = 0;
+    _is_stopped = false;
+    
+    _pool = new threadPool(config.num_threads);
+    _search_control = make_shared<searchControl>(shared_ptr<searchControl>());
+    
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) throw runtime_error("Socket path too long " + socket_path);
+    socket_path.copy(address.sun_path, socket_path.size());
+    
+    /* a stale socket of an earlier server is replaced, any other file is left alone */
+    struct stat file_stat;
+    if (lstat(socket_path.c_str(), &file_stat) == 0) {
+        if (!S_ISSOCK(file_stat.st_mode)) throw runtime_error("Not a socket " + socket_path);
+        unlink(socket_path.c_str());
+    }
+    
+    _listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_listener < 0) throw runtime_error("Can not create socket " + socket_path);
+    if (bind(_listener, (sockaddr*)&address, sizeof(address)) < 0 || listen(_listener, 64) < 0) {
+        close(_listener);
+        throw runtime_error("Can not listen on socket " + socket_path);
+    }
+}
+
+synthesisServer::~synthesisServer() {
+    stop();
+    {
+        unique_lock<mutex> lock(_connections_mutex);
+        for (auto connection : _connections) shutdown(connection, SHUT_RDWR);
+        _connections_closed.wait(lock, [this]() { return _connections.empty(); });
+    }
+    close(_listener);
+    unlink(_socket_path.c_str());
+    delete _pool;
+}
+
+/******************************************
+    Serving
+ */
+void synthesisServer::serve() {
+    while (!_is_stopped) {
+        int connection = accept(_listener, nullptr, nullptr);
+        if (connection < 0) {
+            if (_is_stopped) break;
+            continue;
+        }
+        
+        lock_guard<mutex> lock(_connections_mutex);
+        _connections.insert(connection);
+        thread([this, connection]() {
+            handle_connection(connection);
+        }).detach();
+    }
+}
+
+void synthesisServer::stop() {
+    _is_stopped = true;
+    _search_control->cancel();
+    shutdown(_listener, SHUT_RDWR);
+}
+
+void synthesisServer::handle_connection(int connection) {
+    string request;
+    while (!_is_stopped) {
+        /* the payload of a refused frame is left unread, so the connection ends with the error */
+        bool is_too_large = false;
+        try {
+            if (!read_frame(connection, &request, &is_too_large)) {
+                if (is_too_large) write_frame(connection, "Error : frame over " + to_string(_max_frame_size) + " bytes\n");
+                break;
+            }
+        } catch (const exception& e) {
+            write_frame(connection, string("Error : ") + e.what() + "\n");
+            break;
+        }
+        
+        string response;
+        if (_num_of_requests.fetch_add(1) >= _max_requests) {
+            response = "Busy : " + to_string(_max_requests) + " requests running\n";
+        } else {
+            try {
+                response = handle_request(request);
+            } catch (const exception& e) {
+                response = string("Error : ") + e.what() + "\n";
+            }
+        }
+        _num_of_requests--;
+        if (!write_frame(connection, response)) break;
+    }
+    
+    lock_guard<mutex> lock(_connections_mutex);
+    _connections.erase(connection);
+    close(connection);
+    _connections_closed.notify_all();
+}
+
+string synthesisServer::handle_request(const string& request) {
+    istringstream lines(request);
+    string request_options;
+    getline(lines, request_options);
+    synthesis_config_t config = _config;
+    _request_parser(request_options, &config);
+    
+    input_outputs_t input_outputs;
+    string line;
+    while (getline(lines, line)) {
+        input_output_t input_output;
+        istringstream ss(line);
+        string var;
+        int value;
+        while (ss >> var >> value) {
+            input_output[var] = value;
+        }
+        if (!input_output.empty()) input_outputs.push_back(input_output);
+    }
+    if (input_outputs.empty()) throw runtime_error("No examples in request");
+    
+    /* requests differing only in the order of their examples share a cache entry */
+    vector<string> examples;
+    for (auto ioe : input_outputs) {
+        string example;
+        for (auto var_value : ioe) example += var_value.first + " " + to_string(var_value.second) + " ";
+        examples.push_back(example);
+    }
+    sort(examples.begin(), examples.end());
+    string cache_key = request_options;
+    for (auto example : examples) cache_key += "\n" + example;
+    {
+        lock_guard<mutex> lock(_result_cache_mutex);
+        auto it = _result_cache.find(cache_key);
+        if (it != _result_cache.end()) return it->second + "Cache : hit\n";
+    }
+    
+    /* the connection thread only helps with the searches of its own request while it waits, a COVER request runs on it alone */
+    threadPool* pool = (config.unification_engine == "COVER") ? nullptr : _pool;
+    synthesis_result_t result = synthesize(config, input_outputs, synthesis_callbacks_t(), _search_control, pool);
+    
+    ostringstream response;
+    dump_synthesis_result(result, response);
+    response << "Stats : " << fixed << setprecision(3) << result.stats.seconds << " seconds, "
+             << result.stats.num_of_searches << " searches, " << result.stats.num_of_covered << " / " << result.stats.num_of_examples << " examples" << endl;
+    
+    /* only found programs are cached, a program not found may be found with a longer deadline */
+    if (result.is_found) {
+        lock_guard<mutex> lock(_result_cache_mutex);
+        if (_result_cache.size() >= _result_cache_capacity) _result_cache.clear();
+        _result_cache[cache_key] = response.str();
+    }
+    return response.str();
+}
+
+/******************************************
+    Framing
+ */
+bool synthesisServer::read_frame(int connection, string* payload, bool* is_too_large) {
+    string header;
+    char c;
+    while (true) {
+        if (read(connection, &c, 1) != 1) return false;
+        if (c == '\n') break;
+        if (!isdigit(c) || header.size() > 9) return false;
+        header += c;
+    }
+    if (header.empty()) return false;
+    
+    size_t size = stoul(header);
+    if (size > _max_frame_size) {
+        *is_too_large = true;
+        return false;
+    }
+    payload->assign(size, '\0');
+    size_t offset = 0;
+    while (offset < size) {
+        ssize_t num_of_bytes = read(connection, &(*payload)[offset], size - offset);
+        if (num_of_bytes <= 0) return false;
+        offset += num_of_bytes;
+    }
+    return true;
+}
+
+bool synthesisServer::write_frame(int connection, const string& payload) {
+    string frame = to_string(payload.size()) + "\n" + payload;
+    size_t offset = 0;
+    while (offset < frame.size()) {
+        /* a client gone meanwhile must not raise SIGPIPE */
+        ssize_t num_of_bytes = send(connection, frame.data() + offset, frame.size() - offset, MSG_NOSIGNAL);
+        if (num_of_bytes <= 0) return false;
+        offset += num_of_bytes;
+    }
+    return true;
+}
@@ -0,0 +1,88 @@
+#ifndef SYNTHESISSERVER_H
+#define SYNTHESISSERVER_H
+
+#include "searchControl.hpp"
+#include "synthesizer.hpp"
+#include "threadPool.hpp"
+#include "typeDef.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+//#define DEBUG
+
+/* Options of a request on top of the configuration of the server */
+typedef function<void(const string& request_options, synthesis_config_t* config)> request_parser_t;
+
+/*
+ Synthesis server: a long-lived process answering synthesis requests on a
+ Unix domain socket, so requests do not pay process start and cold caches.
+ Requests share one pool and the program banks of their languages, and the
+ programs found are cached by options and examples.
+ 
+ Frames are a decimal byte count on its own line followed by the payload.
+ A request payload is a line of command line options then the examples, one
+ per line in the IOE file format. The response payload is the dump of the
+ result and its stats, "Busy" when the server is saturated, or an error.
+ */
+class synthesisServer {
+public:
+    synthesisServer(string socket_path, synthesis_config_t config, request_parser_t request_parser, int max_requests);
+    ~synthesisServer();
+    
+    /* accept connections until stopped, every connection sends any number of requests */
+    void serve();
+    
+    /* stop accepting and cancel the running requests, safe to call from a signal handler */
+    void stop();
+
+private:
+    void handle_connection(int connection);
+    string handle_request(const string& request);
+    
+    /* framing, a frame over the maximum size is refused before its payload is read */
+    bool read_frame(int connection, string* payload, bool* is_too_large);
+    static bool write_frame(int connection, const string& payload);
+    
+    string _socket_path;
+    int _listener = -1;
+    atomic<bool> _is_stopped;
+    size_t _max_frame_size = 16 << 20;
+    
+    /* server configuration, completed by the options of every request */
+    synthesis_config_t _config;
+    request_parser_t _request_parser;
+    
+    /* shared by the requests, cancelled on stop */
+    threadPool* _pool;
+    shared_ptr<searchControl> _search_control;
+    
+    /* requests over the limit are answered Busy right away */
+    atomic<int> _num_of_requests;
+    int _max_requests;
+    
+    /* programs found, by request options and sorted examples */
+    unordered_map<string, string> _result_cache;
+    size_t _result_cache_capacity = 1 << 16;
+    mutex _result_cache_mutex;
+    
+    /* open connections, each served by a thread of its own and shut down with the server */
+    set<int> _connections;
+    mutex _connections_mutex;
+    condition_variable _connections_closed;
+};
+
+#endif
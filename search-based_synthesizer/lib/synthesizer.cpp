@@ -0,0 +1,428 @@
+#include "synthesizer.hpp"
+#include <sys/resource.h>
+/******************************************
+    Language configuration
+ */
+void language_configuration(language_config_t* language, vector<string> vars) {
+    
+    if (language->depth_bound_for_predicate == -1) {
+        language->depth_bound_for_predicate = 6;
+    }
+    /*
+     specify the language u use
+     */
+    if (language->int_ops_for_predicate.size() == 0) {
+        language->int_ops_for_predicate.push_back("VAR");
+        language->int_ops_for_predicate.push_back("NUM");
+        language->int_ops_for_predicate.push_back("PLUS");
+        //language->int_ops_for_predicate.push_back("MINUS");
+        language->int_ops_for_predicate.push_back("TIMES");
+        //language->int_ops_for_predicate.push_back("ITE");
+    }
+    
+    if (language->bool_ops_for_predicate.size() == 0) {
+        language->bool_ops_for_predicate.push_back("F");
+        language->bool_ops_for_predicate.push_back("AND");
+        language->bool_ops_for_predicate.push_back("NOT");
+        language->bool_ops_for_predicate.push_back("LT");
+    }
+    
+    if (language->constants_in_predicate.size() == 0) {
+        language->constants_in_predicate.push_back("0");
+        language->constants_in_predicate.push_back("1");
+        language->constants_in_predicate.push_back("2");
+        language->constants_in_predicate.push_back("3");
+        language->constants_in_predicate.push_back("5");
+        language->constants_in_predicate.push_back("7");
+        language->constants_in_predicate.push_back("11");
+        language->constants_in_predicate.push_back("13");
+        language->constants_in_predicate.push_back("17");
+        language->constants_in_predicate.push_back("19");
+        language->constants_in_predicate.push_back("23");
+        language->constants_in_predicate.push_back("29");
+        language->constants_in_predicate.push_back("31");
+        language->constants_in_predicate.push_back("41");
+        language->constants_in_predicate.push_back("43");
+        language->constants_in_predicate.push_back("47");
+        language->constants_in_predicate.push_back("53");
+    }
+    
+    if (language->depth_bound_for_term == -1) {
+        language->depth_bound_for_term = 6;
+    }
+    
+    if (language->int_ops_for_term.size() == 0) {
+        language->int_ops_for_term.push_back("VAR");
+        language->int_ops_for_term.push_back("NUM");
+        language->int_ops_for_term.push_back("PLUS");
+        language->int_ops_for_term.push_back("TIMES");
+        
+        //language->int_ops_for_term.push_back("MINUS");
+        //language->int_ops_for_term.push_back("ITE");
+    }
+    
+    if (language->constants_in_term.size() == 0) {
+        language->constants_in_term.push_back("0");
+        language->constants_in_term.push_back("1");
+        language->constants_in_term.push_back("2");
+        language->constants_in_term.push_back("3");
+        language->constants_in_term.push_back("5");
+        language->constants_in_term.push_back("7");
+        language->constants_in_term.push_back("11");
+        language->constants_in_term.push_back("13");
+        language->constants_in_term.push_back("17");
+        language->constants_in_predicate.push_back("19");
+        language->constants_in_predicate.push_back("23");
+        language->constants_in_predicate.push_back("29");
+        language->constants_in_predicate.push_back("31");
+        language->constants_in_predicate.push_back("41");
+        language->constants_in_predicate.push_back("43");
+        language->constants_in_predicate.push_back("47");
+        language->constants_in_predicate.push_back("53");
+    }
+    
+    /*
+     varables are extracted from inputoutput examples, once, so configuring a language twice keeps it the same
+     */
+    for (auto var : vars) {
+        if (var == "_out") continue;
+        if (find(language->vars_in_predicate.begin(), language->vars_in_predicate.end(), var) == language->vars_in_predicate.end()) {
+            language->vars_in_predicate.push_back(var);
+        }
+        if (find(language->vars_in_term.begin(), language->vars_in_term.end(), var) == language->vars_in_term.end()) {
+            language->vars_in_term.push_back(var);
+        }
+    }
+    
+    return;
+}
+
+void language_configuration(language_config_t* language, input_outputs_t input_outputs) {
+    vector<string> vars;
+    if (!input_outputs.empty()) {
+        for (auto varValue : input_outputs[0]) vars.push_back(varValue.first);
+    }
+    language_configuration(language, vars);
+}
+
+/******************************************
+    Synthesis
+ */
+static long get_peak_memory_in_kb() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss;
+}
+
+static synthesis_result_t synthesize_examples(synthesis_config_t config,
+                                              exampleTable* example_table,
+                                              synthesis_callbacks_t callbacks,
+                                              shared_ptr<searchControl> search_control,
+                                              threadPool* pool) {
+    auto start = chrono::steady_clock::now();
+
+#ifdef DEBUG
+    if (config.language.rules_to_apply.empty()) {
+        cout << "No mode specific rules specified" << endl;
+    }
+    else {
+        cout << "Applying rules: " << endl;
+        for (auto rule : config.language.rules_to_apply) {
+            cout << rule << " ";
+        }
+        cout << endl;
+    }
+#endif
+    
+    /*
+     language configuration
+    */
+    language_configuration(&config.language, example_table->get_vars());
+    language_config_t& language = config.language;
+    
+    if (config.split_strategies.empty()) {
+        config.split_strategies = {"HALF", "FREQUENT", "REGION", "LINEARREGION", "SEPARABLE"};
+    }
+    
+    /* the callbacks cancel a scope of their own, nested in the caller's control and bounded by the deadline */
+    shared_ptr<searchControl> cancel_control = (config.deadline_in_seconds > 0) ? make_shared<searchControl>(config.deadline_in_seconds, search_control)
+                                                                                : make_shared<searchControl>(search_control);
+    progress_callback_t progress_callback = [callbacks, cancel_control](const search_progress_t& progress) {
+        if (callbacks.on_progress) callbacks.on_progress(progress);
+        if (callbacks.should_cancel && callbacks.should_cancel()) cancel_control->cancel();
+    };
+    
+    synthesis_result_t result;
+    result.programs = make_shared<programArena>();
+    result.stats.num_of_examples = example_table->size();
+    search_progress_t progress;
+    
+    /* cover-based unification enumerates terms once and learns guards over them, on input-output maps */
+    if (config.unification_engine == "COVER") {
+        coverUnification* cover_uni = new coverUnification(language.depth_bound_for_predicate, language.int_ops_for_predicate, language.vars_in_predicate, language.constants_in_predicate,
+                                                           language.depth_bound_for_term, language.int_ops_for_term, language.bool_ops_for_term, language.vars_in_term, language.constants_in_term,
+                                                           language.rules_to_apply,
+                                                           config.bench_name, config.ref_id,
+                                                           config.num_growing_speed, config.num_growing_upperbound,
+                                                           example_table->get_input_outputs());
+#ifdef DEBUG
+        cout << "Search time: terms " << config.search_time_for_terms_in_seconds << " predications " << config.search_time_for_predicates_in_seconds << endl;
+        cover_uni->dump_language_defination();
+#endif
+        cover_uni->set_search_control(cancel_control);
+        if (config.anytime_deadline_in_seconds > 0) {
+            cover_uni->set_anytime(config.anytime_deadline_in_seconds);
+        }
+        cover_uni->set_progress_callback(progress_callback);
+        
+        cover_uni->search_program(config.search_time_for_terms_in_seconds, config.search_time_for_predicates_in_seconds);
+        
+        result.program = cover_uni->get_program();
+        if (config.anytime_deadline_in_seconds > 0 && result.program == nullptr) result.partial_program = cover_uni->get_partial_program();
+        result.stats.num_of_covered = cover_uni->get_num_of_covered();
+        result.stats.profile = cover_uni->get_profile();
+        result.stats.tree_shape = cover_uni->get_tree_shape();
+        progress = cover_uni->get_progress();
+        cover_uni->move_programs_to(result.programs.get());
+        
+        delete cover_uni;
+    } else {
+        /* a batch shares one pool between its files, otherwise the synthesis owns its pool */
+        threadPool* own_pool = nullptr;
+        if (pool == nullptr) {
+            own_pool = new threadPool(config.num_threads);
+            pool = own_pool;
+        }
+        
+        unification* uni = new unification(language.depth_bound_for_predicate, language.int_ops_for_predicate, language.bool_ops_for_predicate, language.vars_in_predicate, language.constants_in_predicate,
+                                           language.depth_bound_for_term, language.int_ops_for_term, language.bool_ops_for_term, language.vars_in_term, language.constants_in_term,
+                                           language.rules_to_apply,
+                                           config.bench_name, config.ref_id,
+                                           config.num_growing_speed, config.num_growing_upperbound,
+                                           config.predicate_backend,
+                                           config.split_strategies,
+                                           pool,
+                                           example_table);
+#ifdef DEBUG
+        cout << "Search time: terms " << config.search_time_for_terms_in_seconds << " predications " << config.search_time_for_predicates_in_seconds << endl;
+        uni->dump_language_defination();
+#endif
+        uni->set_search_control(cancel_control);
+        if (config.anytime_deadline_in_seconds > 0) {
+            uni->set_anytime(config.anytime_deadline_in_seconds);
+        }
+        uni->set_progress_callback(progress_callback);
+        budgetScheduler* budget_scheduler = nullptr;
+        if (config.budget_history_file != "") {
+            budget_scheduler = new budgetScheduler(config.budget_history_file, config.bench_name, config.search_time_for_terms_in_seconds, config.search_time_for_predicates_in_seconds);
+            uni->set_budget_scheduler(budget_scheduler);
+        }
+        if (config.checkpoint_file != "") {
+            uni->set_checkpoint(config.checkpoint_file);
+        }
+        
+        string searched_program = uni->search(config.search_time_for_terms_in_seconds, config.search_time_for_predicates_in_seconds);
+        
+        if (config.checkpoint_file != "" && searched_program == "") {
+            uni->save_checkpoint();
+        }
+        if (budget_scheduler != nullptr) {
+            budget_scheduler->save_history();
+        }
+
+#ifdef DEBUG
+        uni->dump_searched_program();
+#endif
+        
+        result.program = uni->get_program();
+        if (config.anytime_deadline_in_seconds > 0 && result.program == nullptr) result.partial_program = uni->get_partial_program();
+        result.stats.num_of_covered = uni->get_num_of_covered();
+        result.stats.profile = uni->get_profile();
+        result.stats.tree_shape = uni->get_tree_shape();
+        progress = uni->get_progress();
+        uni->move_programs_to(result.programs.get());
+        
+        delete uni;
+        delete budget_scheduler;
+        delete own_pool;
+    }
+    
+    result.is_found = (result.program != nullptr);
+    result.stats.num_of_searches = progress.num_of_searches;
+    result.stats.num_of_found = progress.num_of_found;
+    result.stats.is_cancelled = cancel_control->is_cancelled();
+    result.stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+/* cover-based unification searches on the calling thread, without the options of the split engine */
+static void check_cover_config(const synthesis_config_t& config, threadPool* pool) {
+    if (config.unification_engine != "COVER") return;
+    if (pool != nullptr) throw runtime_error("-NUMTHREADS: not with -UNIFICATION COVER, it searches on the calling thread");
+    if (config.checkpoint_file != "") throw runtime_error("-CHECKPOINT: not with -UNIFICATION COVER");
+    if (config.budget_history_file != "") throw runtime_error("-BUDGETHISTORY: not with -UNIFICATION COVER");
+    if (config.predicate_backend != "ENUM") throw runtime_error("-PREDBACKEND: not with -UNIFICATION COVER, it learns its guards itself");
+}
+
+synthesis_result_t synthesize(synthesis_config_t config,
+                              input_outputs_t input_outputs,
+                              synthesis_callbacks_t callbacks,
+                              shared_ptr<searchControl> search_control,
+                              threadPool* pool) {
+    exampleTable example_table(input_outputs);
+    return synthesize(config, &example_table, callbacks, search_control, pool);
+}
+
+synthesis_result_t synthesize(synthesis_config_t config,
+                              exampleTable* example_table,
+                              synthesis_callbacks_t callbacks,
+                              shared_ptr<searchControl> search_control,
+                              threadPool* pool) {
+    check_cover_config(config, pool);
+    
+    int num_of_examples = example_table->size();
+    if (config.sampling_rate >= 1 || num_of_examples == 0) {
+        synthesis_result_t result = synthesize_examples(config, example_table, callbacks, search_control, pool);
+        result.stats.num_of_sampled = num_of_examples;
+        result.stats.num_of_sampling_rounds = 1;
+        result.stats.peak_memory_in_kb = get_peak_memory_in_kb();
+        return result;
+    }
+    auto start = chrono::steady_clock::now();
+    
+    /* the languages come from all the examples, a sample may miss constant columns */
+    language_configuration(&config.language, example_table->get_vars());
+    
+    sampler example_sampler(config.sampling_rate, config.sampling_seed);
+    vector<int> sample_ids = example_sampler.sampleIds(example_table, config.sampling_strata);
+    synthesis_result_t result;
+    search_profile_t profile;
+    int num_of_rounds = 0;
+    int deadline_in_seconds = config.deadline_in_seconds;
+    while (true) {
+        /* the rounds share the deadline */
+        if (deadline_in_seconds > 0) {
+            double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            config.deadline_in_seconds = max(1, (int)ceil(deadline_in_seconds - elapsed));
+        }
+        exampleTable sample = example_table->select(sample_ids);
+        result = synthesize_examples(config, &sample, callbacks, search_control, pool);
+        result.stats.num_of_sampled = sample.size();
+        profile.merge(result.stats.profile);
+        num_of_rounds++;
+        if (!config.is_progressive_sampling || !result.is_found || result.stats.is_cancelled || sample_ids.size() == num_of_examples) break;
+        
+        /* check the program on the held-out examples, at most double the sample with the failing ones */
+        IntType* program = dynamic_cast<IntType*>(result.program);
+        vector<int> failed_ids;
+        int next_sampled = 0;
+        input_output_t ioe;
+        for (int id = 0; id < num_of_examples; id++) {
+            if (next_sampled < sample_ids.size() && sample_ids[next_sampled] == id) {
+                next_sampled++;
+            } else if (program == nullptr) {
+                failed_ids.push_back(id);
+            } else {
+                example_table->get_input_output(id, &ioe);
+                if (program->interpret(ioe) != example_table->get_output(id)) failed_ids.push_back(id);
+            }
+        }
+        if (failed_ids.empty()) break;
+#ifdef DEBUG
+        cout << "Sampling round " << num_of_rounds << ": " << failed_ids.size() << " held-out examples failed" << endl;
+#endif
+        vector<int> added_ids = example_sampler.pickIds(failed_ids, sample_ids.size());
+        vector<int> grown_ids;
+        merge(sample_ids.begin(), sample_ids.end(), added_ids.begin(), added_ids.end(), back_inserter(grown_ids));
+        sample_ids = grown_ids;
+    }
+    
+    result.stats.num_of_sampling_rounds = num_of_rounds;
+    result.stats.profile = profile;
+    result.stats.peak_memory_in_kb = get_peak_memory_in_kb();
+    result.stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+future<synthesis_result_t> synthesize_async(synthesis_config_t config,
+                                            input_outputs_t input_outputs,
+                                            synthesis_callbacks_t callbacks,
+                                            shared_ptr<searchControl> search_control) {
+    return async(launch::async, [config, input_outputs, callbacks, search_control]() -> synthesis_result_t {
+        return synthesize(config, input_outputs, callbacks, search_control);
+    });
+}
+
+/******************************************
+    Dumping funcions
+ */
+void dump_synthesis_result(const synthesis_result_t& result, ostream& out) {
+    if (result.program != nullptr) {
+        out << "Searched Program (^0^) : " << result.program->to_string() << endl;
+    } else {
+        out << "Not yet found, (T^T)" << endl;
+        if (result.partial_program != nullptr) {
+            int num_of_examples = result.stats.num_of_examples;
+            out << "Partial Program (^-^) : " << result.partial_program->to_string() << endl;
+            out << "Coverage : " << result.stats.num_of_covered << " / " << num_of_examples << " examples ("
+                << fixed << setprecision(2) << 100.0 * result.stats.num_of_covered / num_of_examples << "%)" << endl;
+        }
+    }
+}
+
+string json_quote(const string& text) {
+    ostringstream quoted;
+    quoted << '"';
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted << '\\' << c;
+        } else if (c == '\n') {
+            quoted << "\\n";
+        } else if (c < 0x20) {
+            quoted << "\\u" << hex << setw(4) << setfill('0') << (int)c << dec;
+        } else {
+            quoted << c;
+        }
+    }
+    quoted << '"';
+    return quoted.str();
+}
+
+void dump_synthesis_result_json(const synthesis_result_t& result, const vector<string>& files, ostream& out) {
+    const synthesis_stats_t& stats = result.stats;
+    const search_profile_t& profile = stats.profile;
+    auto dump_list = [](const vector<size_t>& list) {
+        string text = "[";
+        for (int i = 0; i < list.size(); i++) text += ((i > 0) ? "," : "") + to_string(list[i]);
+        return text + "]";
+    };
+    
+    ostringstream record;
+    record << fixed << setprecision(3);
+    record << "{\"files\":[";
+    for (int i = 0; i < files.size(); i++) record << ((i > 0) ? "," : "") << json_quote(files[i]);
+    record << "],\"found\":" << (result.is_found ? "true" : "false")
+           << ",\"program\":" << ((result.program != nullptr) ? json_quote(result.program->to_string()) : "null")
+           << ",\"partial_program\":" << ((result.partial_program != nullptr) ? json_quote(result.partial_program->to_string()) : "null")
+           << ",\"cached\":false"
+           << ",\"seconds\":" << stats.seconds
+           << ",\"examples\":" << stats.num_of_examples
+           << ",\"sampled\":" << stats.num_of_sampled
+           << ",\"sampling_rounds\":" << stats.num_of_sampling_rounds
+           << ",\"covered\":" << stats.num_of_covered
+           << ",\"searches\":" << stats.num_of_searches
+           << ",\"found_searches\":" << stats.num_of_found
+           << ",\"cancelled\":" << (stats.is_cancelled ? "true" : "false")
+           << ",\"tree\":{\"nodes\":" << stats.tree_shape.num_of_nodes
+           << ",\"leaves\":" << stats.tree_shape.num_of_leaves
+           << ",\"depth\":" << stats.tree_shape.depth << "}"
+           << ",\"phases\":{\"term_search\":" << profile.term_search_seconds
+           << ",\"predicate_search\":" << profile.predicate_search_seconds
+           << ",\"grow\":" << profile.grow_seconds
+           << ",\"eliminate\":" << profile.eliminate_seconds
+           << ",\"evaluate\":" << profile.evaluate_seconds << "}"
+           << ",\"term_bank_sizes\":" << dump_list(profile.term_bank_sizes)
+           << ",\"predicate_bank_sizes\":" << dump_list(profile.predicate_bank_sizes)
+           << ",\"peak_memory_kb\":" << stats.peak_memory_in_kb << "}";
+    out << record.str() << endl;
+}
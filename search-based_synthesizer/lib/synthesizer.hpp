@@ -0,0 +1,160 @@
+#ifndef SYNTHESIZER_H
+#define SYNTHESIZER_H
+
+#include "budgetScheduler.hpp"
+#include "coverUnification.hpp"
+#include "exampleTable.hpp"
+#include "langDef.hpp"
+#include "programBank.hpp"
+#include "sampler.hpp"
+#include "searchControl.hpp"
+#include "threadPool.hpp"
+#include "typeDef.hpp"
+#include "unification.hpp"
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+//#define DEBUG
+
+/*
+ Library entry point of the synthesizer: synthesize a program from examples
+ held in memory, without IOE files or command lines. symRiSynthesiser is one
+ client of it.
+ */
+
+/* Languages of predicates and terms, the unset ones are completed by language_configuration */
+struct language_config_t {
+    int depth_bound_for_predicate = -1;
+    vector<string> int_ops_for_predicate;
+    vector<string> bool_ops_for_predicate;
+    vector<string> vars_in_predicate;
+    vector<string> constants_in_predicate;
+    int depth_bound_for_term = -1;
+    vector<string> int_ops_for_term;
+    vector<string> bool_ops_for_term;
+    vector<string> vars_in_term;
+    vector<string> constants_in_term;
+    
+    vector<string> rules_to_apply;
+};
+
+/* Configuration of one synthesis */
+struct synthesis_config_t {
+    language_config_t language;
+    
+    int search_time_for_terms_in_seconds = 20;
+    int search_time_for_predicates_in_seconds = 20;
+    
+    /* benchmark and reference the examples come from, keys of the budget history */
+    string bench_name = "";
+    int ref_id = 0;
+    
+    int num_growing_speed = 1;
+    int num_growing_upperbound = 100;
+    
+    string predicate_backend = "ENUM";
+    
+    vector<string> split_strategies;
+    
+    string unification_engine = "SPLIT";
+    
+    int anytime_deadline_in_seconds = -1;
+    
+    /* hard deadline of the whole synthesis, -1 for none */
+    int deadline_in_seconds = -1;
+    
+    string checkpoint_file = "";
+    
+    string budget_history_file = "";
+    
+    /* synthesize on a sample of the examples, strata RANDOM, GRID or OUTPUT; progressive sampling adds
+       the examples the program fails on to the sample until it is correct on all of them */
+    double sampling_rate = 1;
+    string sampling_strata = "GRID";
+    bool is_progressive_sampling = false;
+    unsigned sampling_seed = 0;
+    
+    int num_threads = thread::hardware_concurrency();
+};
+
+/* Called from the search threads, one call at a time */
+struct synthesis_callbacks_t {
+    /* after every finished search */
+    progress_callback_t on_progress;
+    /* polled after every finished search, true cancels the synthesis */
+    function<bool()> should_cancel;
+};
+
+struct synthesis_stats_t {
+    double seconds = 0;
+    int num_of_examples = 0;
+    int num_of_sampled = 0;         // examples of the last sample synthesized on
+    int num_of_sampling_rounds = 0;
+    int num_of_covered = 0;         // examples the program, or the partial program, is correct on
+    int num_of_searches = 0;
+    int num_of_found = 0;
+    bool is_cancelled = false;
+    
+    /* time per search phase and program list sizes, summed over the search threads and sampling rounds */
+    search_profile_t profile;
+    unification_shape_t tree_shape;
+    long peak_memory_in_kb = 0;     // of the whole process
+};
+
+/* The searched program, or in anytime mode the best partial one, and the arena owning its nodes */
+struct synthesis_result_t {
+    bool is_found = false;
+    BaseType* program = nullptr;
+    BaseType* partial_program = nullptr;
+    shared_ptr<programArena> programs;
+    synthesis_stats_t stats;
+};
+
+/* Complete a language configuration with the defaults and the variables of the examples */
+void language_configuration(language_config_t* language, vector<string> vars);
+void language_configuration(language_config_t* language, input_outputs_t input_outputs);
+
+/*
+ Synthesize a program, blocking until one is found, the budgets run out or
+ the synthesis is cancelled by the callbacks or the search control. Runs on
+ the given pool, or on a pool of its own. The COVER engine runs on the calling
+ thread and takes no pool, checkpoint, budget history or predicate backend.
+ The examples stay in a table, input-output maps are only built for the
+ searches that read them.
+ */
+synthesis_result_t synthesize(synthesis_config_t config,
+                              input_outputs_t input_outputs,
+                              synthesis_callbacks_t callbacks = synthesis_callbacks_t(),
+                              shared_ptr<searchControl> search_control = nullptr,
+                              threadPool* pool = nullptr);
+synthesis_result_t synthesize(synthesis_config_t config,
+                              exampleTable* example_table,
+                              synthesis_callbacks_t callbacks = synthesis_callbacks_t(),
+                              shared_ptr<searchControl> search_control = nullptr,
+                              threadPool* pool = nullptr);
+
+/* Synthesize on a thread of its own, cancel the search control to stop it early */
+future<synthesis_result_t> synthesize_async(synthesis_config_t config,
+                                            input_outputs_t input_outputs,
+                                            synthesis_callbacks_t callbacks = synthesis_callbacks_t(),
+                                            shared_ptr<searchControl> search_control = nullptr);
+
+/* Dump a result the way the unifications do */
+void dump_synthesis_result(const synthesis_result_t& result, ostream& out);
+
+/* Dump a result and its stats as one JSON line, for the files it was synthesized from */
+void dump_synthesis_result_json(const synthesis_result_t& result, const vector<string>& files, ostream& out);
+
+/* A string as a JSON string literal */
+string json_quote(const string& text);
+
+#endif
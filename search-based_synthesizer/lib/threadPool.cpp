@@ -0,0 +1,120 @@
+#include "threadPool.hpp"
+
+/* worker identity of the current thread */
+static thread_local threadPool* current_pool = nullptr;
+static thread_local int current_worker_id = -1;
+
+/******************************************
+    Constructor
+ */
+threadPool::threadPool(int num_of_threads) {
+    if (num_of_threads < 1) num_of_threads = 1;
+    _num_of_queued_tasks = 0;
+    for (int i = 0; i < num_of_threads; i++) {
+        _worker_queues.push_back(unique_ptr<task_queue_t>(new task_queue_t()));
+    }
+    for (int i = 0; i < num_of_threads; i++) {
+        _workers.push_back(thread(&threadPool::worker_loop, this, i));
+    }
+}
+
+threadPool::~threadPool() {
+    {
+        unique_lock<mutex> lock(_mutex);
+        _stopped = true;
+    }
+    _condition.notify_all();
+    for (auto &worker : _workers) {
+        worker.join();
+    }
+}
+
+int threadPool::get_number_of_threads() {
+    return _workers.size();
+}
+
+/******************************************
+    Task queues
+ */
+threadPool::task_queue_t* threadPool::get_own_queue() {
+    if (current_pool != this || current_worker_id < 0) return nullptr;
+    return _worker_queues[current_worker_id].get();
+}
+
+shared_ptr<threadPool::task_node_t>& threadPool::get_current_task() {
+    static thread_local shared_ptr<task_node_t> current_task;
+    if (current_task == nullptr && current_worker_id < 0) current_task = make_shared<task_node_t>();
+    return current_task;
+}
+
+bool threadPool::is_descendant(const task_node_t* node, const task_node_t* ancestor) {
+    if (ancestor == nullptr) return true;
+    for (const task_node_t* parent = node->parent.get(); parent != nullptr; parent = parent->parent.get()) {
+        if (parent == ancestor) return true;
+    }
+    return false;
+}
+
+void threadPool::push(function<void()> task) {
+    task_queue_t* queue = get_own_queue();
+    if (queue == nullptr) queue = &_shared_queue;
+    queued_task_t queued = {task, make_shared<task_node_t>()};
+    queued.node->parent = get_current_task();
+    {
+        unique_lock<mutex> queue_lock(queue->queue_mutex);
+        queue->tasks.push_back(queued);
+    }
+    {
+        unique_lock<mutex> lock(_mutex);
+        _num_of_queued_tasks++;
+    }
+    _condition.notify_one();
+}
+
+bool threadPool::pop(task_queue_t* queue, bool newest_first, task_node_t* ancestor, queued_task_t& task) {
+    unique_lock<mutex> queue_lock(queue->queue_mutex);
+    int size = queue->tasks.size();
+    for (int i = 0; i < size; i++) {
+        int index = newest_first ? size - 1 - i : i;
+        if (!is_descendant(queue->tasks[index].node.get(), ancestor)) continue;
+        task = queue->tasks[index];
+        queue->tasks.erase(queue->tasks.begin() + index);
+        _num_of_queued_tasks--;
+        return true;
+    }
+    return false;
+}
+
+bool threadPool::run_one_task(task_node_t* ancestor) {
+    queued_task_t task;
+    task_queue_t* own_queue = get_own_queue();
+    
+    /* own queue first, then the shared queue, then steal from the other workers */
+    bool found = (own_queue != nullptr && pop(own_queue, true, ancestor, task));
+    if (!found) found = pop(&_shared_queue, false, ancestor, task);
+    for (int i = 0; !found && i < _worker_queues.size(); i++) {
+        int victim = (max(current_worker_id, 0) + i) % _worker_queues.size();
+        if (_worker_queues[victim].get() == own_queue) continue;
+        found = pop(_worker_queues[victim].get(), false, ancestor, task);
+    }
+    if (!found) return false;
+    
+    /* the tasks it submits descend from it */
+    shared_ptr<task_node_t>& current_task = get_current_task();
+    shared_ptr<task_node_t> outer_task = current_task;
+    current_task = task.node;
+    task.run();
+    current_task = outer_task;
+    return true;
+}
+
+void threadPool::worker_loop(int worker_id) {
+    current_pool = this;
+    current_worker_id = worker_id;
+    while (true) {
+        if (run_one_task(nullptr)) continue;
+        unique_lock<mutex> lock(_mutex);
+        _condition.wait(lock, [this]() { return _stopped || _num_of_queued_tasks > 0; });
+        if (_stopped && _num_of_queued_tasks == 0) return;
+    }
+}
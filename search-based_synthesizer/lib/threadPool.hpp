@@ -0,0 +1,130 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+//#define DEBUG
+
+/*
+ Work-stealing thread pool running search tasks in-process.
+ Every worker owns a task queue: tasks submitted from a worker go to its own
+ queue and are run newest first, idle workers steal the oldest tasks of the
+ others. Tasks submitted from outside the pool go to a shared queue.
+ A thread waiting for a task helps running queued tasks, so tasks can wait on
+ the tasks they submit without exhausting the workers. It only helps with the
+ tasks descending from the task it runs, or for a thread outside the pool from
+ the tasks it submitted: the tasks of other files or requests never run on its
+ stack, where they would overrun its deadlines.
+ */
+class threadPool {
+public:
+    threadPool(int num_of_threads);
+    ~threadPool();
+    
+    /* Submit a task, get its result from the returned future */
+    template <typename T>
+    future<T> submit(function<T()> task) {
+        auto packaged = make_shared<packaged_task<T()>>(task);
+        future<T> result = packaged->get_future();
+        push([packaged]() { (*packaged)(); });
+        return result;
+    }
+    
+    /* Submit tasks meant to start in the given order */
+    template <typename T>
+    vector<future<T>> submit_in_order(vector<function<T()>> tasks) {
+        vector<future<T>> results(tasks.size());
+        /* a worker runs its own tasks newest first */
+        if (get_own_queue() != nullptr) {
+            for (int i = (int)tasks.size() - 1; i >= 0; i--) results[i] = submit(tasks[i]);
+        } else {
+            for (int i = 0; i < tasks.size(); i++) results[i] = submit(tasks[i]);
+        }
+        return results;
+    }
+    
+    /* Wait for a task result, running queued tasks meanwhile */
+    template <typename T>
+    T wait(future<T>& result) {
+        task_node_t* ancestor = get_current_task().get();
+        while (result.wait_for(chrono::seconds(0)) != future_status::ready) {
+            if (!run_one_task(ancestor)) {
+                result.wait_for(chrono::milliseconds(1));
+            }
+        }
+        return result.get();
+    }
+    
+    /* Wait until one of the pending task results is ready, running queued tasks meanwhile.
+       Returns its index, or -1 once every result has been taken. */
+    template <typename T>
+    int wait_any(vector<future<T>>& results) {
+        task_node_t* ancestor = get_current_task().get();
+        while (true) {
+            bool has_pending = false;
+            for (int i = 0; i < results.size(); i++) {
+                if (!results[i].valid()) continue;
+                has_pending = true;
+                if (results[i].wait_for(chrono::seconds(0)) == future_status::ready) return i;
+            }
+            if (!has_pending) return -1;
+            if (!run_one_task(ancestor)) {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+        }
+    }
+    
+    int get_number_of_threads();
+
+private:
+    /* a task and the task it was submitted from */
+    struct task_node_t {
+        shared_ptr<task_node_t> parent;
+    };
+    
+    struct queued_task_t {
+        function<void()> run;
+        shared_ptr<task_node_t> node;
+    };
+    
+    struct task_queue_t {
+        deque<queued_task_t> tasks;
+        mutex queue_mutex;
+    };
+    
+    void push(function<void()> task);
+    /* pop a task descending from the ancestor, any task without one */
+    bool pop(task_queue_t* queue, bool newest_first, task_node_t* ancestor, queued_task_t& task);
+    bool run_one_task(task_node_t* ancestor);
+    void worker_loop(int worker_id);
+    
+    /* task run by the calling thread, nullptr for an idle worker, a root of its own for a thread outside the pool */
+    static shared_ptr<task_node_t>& get_current_task();
+    static bool is_descendant(const task_node_t* node, const task_node_t* ancestor);
+    
+    /* queue of the calling thread, nullptr if it is not a worker of this pool */
+    task_queue_t* get_own_queue();
+    
+    vector<thread> _workers;
+    vector<unique_ptr<task_queue_t>> _worker_queues;
+    task_queue_t _shared_queue;
+    
+    atomic<int> _num_of_queued_tasks;
+    mutex _mutex;
+    condition_variable _condition;
+    bool _stopped = false;
+};
+
+#endif
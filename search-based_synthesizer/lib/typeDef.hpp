@@ -1,6 +1,7 @@
 #ifndef TYPEDEF_H
 #define TYPEDEF_H
 
+#include <map>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -17,7 +17,10 @@ unification::unification(int depth_bound_for_predicate,
                          int ref_id,
                          int num_growing_speed,
                          int num_growing_upperbound,
-                         input_outputs_t input_outputs) {
+                         string predicate_backend,
+                         vector<string> split_strategies,
+                         threadPool* pool,
+                         exampleTable* example_table) {
     
     _depth_bound_for_predicate = depth_bound_for_predicate;
     _int_ops_in_predicate = int_ops_in_predicate;
@@ -39,198 +42,447 @@ unification::unification(int depth_bound_for_predicate,
     _num_growing_speed = num_growing_speed;
     _num_growing_upperbound = num_growing_upperbound;
     
-    _input_output_tree = new input_output_tree_node(input_outputs);
+    _predicate_backend = predicate_backend;
     
-    for (auto ioe : input_outputs) {
-        if (ioe["_out"] == 0) {
+    for (auto name : split_strategies) {
+        _split_strategies.push_back(splitStrategy::create(name));
+    }
+    
+    _pool = pool;
+    _search_control = make_shared<searchControl>(shared_ptr<searchControl>());
+    _start = chrono::steady_clock::now();
+    _speculative_split = (_pool->get_number_of_threads() > 1);
+    _result_arena = new programArena();
+    
+    /* examples keep their row in the file's table as a stable id through every split */
+    _example_table = example_table;
+    vector<int> example_ids;
+    for (int i = 0; i < _example_table->size(); i++) example_ids.push_back(i);
+    _input_output_tree = new input_output_tree_node(example_ids);
+    
+    /* grow the low generations once, every search node reuses them through the program bank, growing reads no examples */
+    bottomUpSearch* term_bus = new bottomUpSearch(_depth_bound_for_term,
+                                                  _int_ops_in_term,
+                                                  _bool_ops_in_term,
+                                                  _vars_in_term,
+                                                  _constants_in_term,
+                                                  false,
+                                                  _rules_to_apply,
+                                                  _bench_name,
+                                                  _ref_id,
+                                                  _num_growing_speed,
+                                                  _num_growing_upperbound,
+                                                  input_outputs_t());
+    term_bus->warm_up_bank(_bank_warm_up_generation);
+    delete term_bus;
+    
+    bottomUpSearch* pred_bus = new bottomUpSearch(_depth_bound_for_predicate,
+                                                  _int_ops_in_predicate,
+                                                  _bool_ops_in_predicate,
+                                                  _vars_in_predicate,
+                                                  _constants_in_predicate,
+                                                  true,
+                                                  _rules_to_apply,
+                                                  _bench_name,
+                                                  _ref_id,
+                                                  _num_growing_speed,
+                                                  _num_growing_upperbound,
+                                                  input_outputs_t());
+    pred_bus->warm_up_bank(_bank_warm_up_generation);
+    delete pred_bus;
+    
+    /* cheap Lt atoms of the predicate language, to propose and rank splits, enumerated on the maps of every example */
+    input_outputs_t input_outputs = _example_table->get_input_outputs();
+    _split_atoms = new ltAtomLibrary(input_outputs.size());
+    bottomUpSearch* atom_bus = new bottomUpSearch(_depth_bound_for_predicate,
+                                                  _int_ops_in_predicate,
+                                                  {"LT"},
+                                                  _vars_in_predicate,
+                                                  _constants_in_predicate,
+                                                  true,
+                                                  _rules_to_apply,
+                                                  _bench_name,
+                                                  _ref_id,
+                                                  _num_growing_speed,
+                                                  _num_growing_upperbound,
+                                                  input_outputs);
+    for (auto program : atom_bus->enumerate(_split_atom_generation)) {
+        auto lt = dynamic_cast<Lt*>(program);
+        if (lt == nullptr) continue;
+        vector<bool> values;
+        for (auto &ioe : input_outputs) values.push_back(lt->interpret(ioe));
+        _split_atoms->add_atom(values);
+    }
+    delete atom_bus;
+    
+    for (int i = 0; i < _example_table->size(); i++) {
+        if (_example_table->get_output(i) == 0) {
             this->_has_zero_in_ioes = true;
             break;
         }
     }
 }
 
+unification::~unification() {
+    delete_input_output_tree_node(_input_output_tree);
+    delete _split_atoms;
+    for (auto strategy : _split_strategies) delete strategy;
+    for (auto suspended : _suspended_searches) delete suspended.second.search;
+    delete _result_arena;
+}
+
 /*
  search function
  */
-string unification::search_node_one_pass(int time_bound_in_seconds, input_output_tree_node* node) {
+BaseType* unification::search_node_one_pass(int time_bound_in_seconds, input_output_tree_node* node, shared_ptr<searchControl> parent_control) {
     if (node == NULL) {
-        return "";
+        return nullptr;
     }
     
-    int fd[2];
-    pipe(fd);
-    pid_t pid = fork();
-    
-    string searched_program = "";
-    
+    future<search_result_t> result = _pool->submit(make_search_node_one_pass(time_bound_in_seconds, node, parent_control));
+    return _pool->wait(result).program;
+}
+
+function<search_result_t()> unification::make_search_node_one_pass(int time_bound_in_seconds, input_output_tree_node* node, shared_ptr<searchControl> parent_control,
+                                                                   shared_ptr<searchControl> found_control) {
+    bool is_predicate = (node->left != NULL && node->right != NULL);
+    /* input-output maps are only built for the duration of the search */
+    subproblem_key_t key = make_subproblem_key(node, is_predicate);
+    shared_ptr<searchControl> search_control = make_shared<searchControl>(time_bound_in_seconds, parent_control);
+
 #ifdef DEBUG
-    cerr << "Start child process to run with " << time_bound_in_seconds << " seconds" << endl;
+    cerr << "Start search task to run with " << time_bound_in_seconds << " seconds" << endl;
 #endif
     
-    if (pid == 0) {
-        unsigned seconds_left = time_bound_in_seconds;
-        alarm(seconds_left); // no handler (terminate proc)
+    vector<int> example_ids = node->example_ids;
+    vector<int> outputs = get_node_outputs(node, is_predicate);
+    auto search = [this, is_predicate, example_ids, outputs, key, time_bound_in_seconds, search_control, parent_control]() -> search_result_t {
+        BaseType* searched_program = nullptr;
+        search_result_t result;
         
-        /* do the search */
-        if (node->left != NULL && node->right != NULL) {
-            bottomUpSearch* bus = new bottomUpSearch(_depth_bound_for_predicate,
-                                                     _int_ops_in_predicate,
-                                                     _bool_ops_in_predicate,
-                                                     _vars_in_predicate,
-                                                     _constants_in_predicate,
-                                                     true,
-                                                     _rules_to_apply,
-                                                     _bench_name,
-                                                     _ref_id,
-                                                     _num_growing_speed,
-                                                     _num_growing_upperbound,
-                                                     node->input_outputs);
-            searched_program = bus->search();
-        } else {
-            bottomUpSearch* bus = new bottomUpSearch(_depth_bound_for_term,
-                                                     _int_ops_in_term,
-                                                     _bool_ops_in_term,
-                                                     _vars_in_term,
-                                                     _constants_in_term,
-                                                     false,
-                                                     _rules_to_apply,
-                                                     _bench_name,
-                                                     _ref_id,
-                                                     _num_growing_speed,
-                                                     _num_growing_upperbound,
-                                                     node->input_outputs);
-            searched_program = bus->search();
+        /* answered before, solved or failed within at least this budget */
+        if (lookup_subproblem(key, time_bound_in_seconds, &searched_program)) {
+#ifdef DEBUG
+            cout << "Subproblem memo hit" << endl;
+#endif
+            result.program = searched_program;
+            return result;
         }
-        alarm(0);
-        // maybe write (MAX_SECONDS - seconds_left) to a file
-        
-        /* write searched program to pipe, to parent process */
-        close(fd[0]);
-        write(fd[1], searched_program.c_str(), searched_program.size());
-        close(fd[1]);
-        
-        exit(0);
-    } else {
-    
-        int status;
-        wait(&status);
         
-        /* read searched program in pipe, to child process */
-        close(fd[1]);
-        char read_buffer[1000] = {'\0'};
-        read(fd[0], read_buffer, sizeof(read_buffer));
-        close(fd[0]);
+        input_outputs_t input_outputs = _example_table->get_input_outputs(example_ids, outputs);
+        bool is_exhausted = false;
+        search_profile_t profile;
         
-        searched_program = read_buffer;
-        
-        /* check child process status */
-        if (WIFSIGNALED(status)) {
-            // child was interrupted
-            if (WTERMSIG(status) == SIGALRM) {
-#ifdef DEBUG
-                // child interrupted by alarm signal
-                cout << "Time out for bottom up search" << endl;
-#endif
+        /* do the search, everything it allocates is dropped with it unless a program is found */
+        if (is_predicate && _predicate_backend == "DTREE") {
+            predicateLearner* pl = new predicateLearner(_depth_bound_for_predicate,
+                                                        _int_ops_in_predicate,
+                                                        _vars_in_predicate,
+                                                        _constants_in_predicate,
+                                                        _rules_to_apply,
+                                                        _bench_name,
+                                                        _ref_id,
+                                                        _num_growing_speed,
+                                                        _num_growing_upperbound,
+                                                        input_outputs);
+            auto start = chrono::steady_clock::now();
+            pl->set_search_control(search_control);
+            searched_program = pl->learn_program();
+            is_exhausted = !search_control->is_stopped();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if (searched_program != nullptr && _budget_scheduler != nullptr) {
+                _budget_scheduler->record(is_predicate, seconds);
             }
-            else {
-#ifdef DEBUG
-                // child interrupted by another signal
-                cout << "interrupted by another signal in bottom up search: " << status << endl;
-#endif
+            profile = pl->take_profile();
+            profile.predicate_search_seconds = seconds;
+            if (searched_program != nullptr) pl->move_programs_to(_result_arena);
+            delete pl;
+        } else {
+            bottomUpSearch* bus = nullptr;
+            if (is_predicate) {
+                bus = new bottomUpSearch(_depth_bound_for_predicate,
+                                         _int_ops_in_predicate,
+                                         _bool_ops_in_predicate,
+                                         _vars_in_predicate,
+                                         _constants_in_predicate,
+                                         true,
+                                         _rules_to_apply,
+                                         _bench_name,
+                                         _ref_id,
+                                         _num_growing_speed,
+                                         _num_growing_upperbound,
+                                         input_outputs);
+            } else {
+                bus = new bottomUpSearch(_depth_bound_for_term,
+                                         _int_ops_in_term,
+                                         _bool_ops_in_term,
+                                         _vars_in_term,
+                                         _constants_in_term,
+                                         false,
+                                         _rules_to_apply,
+                                         _bench_name,
+                                         _ref_id,
+                                         _num_growing_speed,
+                                         _num_growing_upperbound,
+                                         input_outputs);
+            }
+            
+            /* a resumed search continues where it stopped, with what is left of its budget */
+            bus = resume_search(key, bus);
+            bus->set_search_control(search_control);
+            bus->set_track_partial(_is_anytime && !is_predicate);
+            chrono::duration<double> budget(time_bound_in_seconds - bus->get_spent_seconds());
+            searched_program = bus->run_until(chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(budget));
+            is_exhausted = bus->is_finished();
+            profile = bus->take_profile();
+            if (searched_program != nullptr && _budget_scheduler != nullptr) {
+                _budget_scheduler->record(is_predicate, bus->get_spent_seconds());
+            }
+            if (searched_program == nullptr && bus->get_partial_program() != nullptr) {
+                result.partial_program = bus->get_partial_program();
+                result.num_of_covered = bus->get_partial_coverage();
+            }
+            if (searched_program != nullptr || result.partial_program != nullptr) bus->move_programs_to(_result_arena);
+            
+            /* out of time searches are extended by the next rounds or runs */
+            bool is_extended_later = (_checkpoint_file != "" || _budget_scheduler != nullptr);
+            if (searched_program == nullptr && !is_exhausted && (search_control->is_cancelled() || is_extended_later)) {
+                suspend_search(key, bus);
+            } else {
+                delete bus;
             }
         }
-        else {
+
 #ifdef DEBUG
-            // child ran to completion
-            if (searched_program == "") {
+        if (searched_program == nullptr) {
+            if (search_control->is_stopped()) {
+                cout << "Time out for bottom up search" << endl;
+            } else {
                 cout << "Complete, failed to find program" << endl;
             }
-            else {
-                cout << "Complete, program found " << searched_program << endl;
-            }
+        }
+        else {
+            cout << "Complete, program found " << searched_program->to_string() << endl;
+        }
 #endif
+        
+        /* a failure only counts once the search ran out of its own budget, not when a parent stopped it early */
+        if (searched_program != nullptr || is_exhausted) {
+            record_subproblem(key, is_exhausted ? INT_MAX : time_bound_in_seconds, searched_program);
+        } else if (!search_control->is_cancelled() && (parent_control == nullptr || !parent_control->is_stopped())) {
+            record_subproblem(key, time_bound_in_seconds, nullptr);
         }
-    }
-    
-    return searched_program;
+        report_progress(searched_program != nullptr, profile);
+        result.program = searched_program;
+        return result;
+    };
+    
+    /* cancel from the search task itself, the thread waiting for it may be busy running a sibling */
+    return [search, found_control]() -> search_result_t {
+        search_result_t result = search();
+        if (result.program != nullptr && found_control != nullptr) found_control->cancel();
+        return result;
+    };
 }
 
-string unification::search_node(int search_time_for_terms_in_seconds,
-                               int search_time_for_predicates_in_seconds,
-                               input_output_tree_node* node) {
-    if (node == nullptr) return "";
-    
+BaseType* unification::search_node(int search_time_for_terms_in_seconds,
+                                   int search_time_for_predicates_in_seconds,
+                                   input_output_tree_node* node,
+                                   shared_ptr<searchControl> search_control) {
+    if (node == nullptr) return nullptr;
+    if (search_control != nullptr && search_control->is_cancelled()) return nullptr;
+
 #ifdef DEBUG
     cout << endl << "Start search node " << node << endl;
 #endif
-    
+
 #ifdef DEBUG
     dump_input_output_tree_node(node, "");
 #endif
     
-    string searched_program = "";
-    if (!_has_zero_in_ioes) searched_program = search_node_one_pass(search_time_for_terms_in_seconds, node);
-    _has_zero_in_ioes = false;
+    /* the root skips the term search when it has zero outputs, those always need a split */
+    bool has_term_search = (node != _input_output_tree || !_has_zero_in_ioes);
+    shared_ptr<searchControl> node_control = make_shared<searchControl>(search_control);
+    vector<function<search_result_t()>> tasks;
+    if (has_term_search) tasks.push_back(make_search_node_one_pass(search_time_for_terms_in_seconds, node, node_control, node_control));
+    int split_offset = tasks.size();
+    
+    /* every proposed split works on its own copy of the node, the best ranked ones start first */
+    vector<input_output_tree_node*> candidates;
+    auto make_split_modes = [&]() {
+        vector<function<search_result_t()>> tasks;
+        for (auto split : propose_splits(node)) {
+            input_output_tree_node* candidate = new input_output_tree_node(node->example_ids);
+            candidate->labels = split.labels;
+            candidate->left = new input_output_tree_node(split.left_example_ids);
+            candidate->right = new input_output_tree_node(split.right_example_ids);
+            candidates.push_back(candidate);
+            tasks.push_back([this, search_time_for_terms_in_seconds, search_time_for_predicates_in_seconds, candidate, node_control]() -> search_result_t {
+                search_result_t result = search_split_node(search_time_for_terms_in_seconds, search_time_for_predicates_in_seconds, candidate, make_shared<searchControl>(node_control));
+                if (result.program != nullptr) node_control->cancel();
+                return result;
+            });
+        }
+        return tasks;
+    };
     
-    /* search a solution for corrent node */
-    if (searched_program == "") {
-#ifdef DEBUG
-        cout << "Failed, try to split node: ";
-#endif
-        for (int mode = 0; mode < 2; mode++) {
-            bool is_split_succeed = split_input_output_tree_node(node, mode);
-            if (is_split_succeed) {
-#ifdef DEBUG
-                cout << "Split current node, succeed" << endl;
-                cout << "Start search condition, ";
-#endif
-                string cond = search_node_one_pass(search_time_for_predicates_in_seconds, node);
-                if (cond != "") {
+    /* split modes start speculatively alongside the term search, otherwise once it failed;
+       submitted together so that a worker runs its term search first, not after its split modes */
+    if (!has_term_search || _speculative_split) {
+        for (auto &task : make_split_modes()) tasks.push_back(task);
+    }
+    vector<future<search_result_t>> results = _pool->submit_in_order(tasks);
+    
+    /* the first complete program, term or split, has cancelled the others from its task */
+    BaseType* searched_program = nullptr;
+    search_result_t best_partial;
+    int winner = -1;
+    int index;
+    while ((index = _pool->wait_any(results)) != -1) {
+        search_result_t result = results[index].get();
+        BaseType* program = result.program;
+        if (result.partial_program != nullptr && result.num_of_covered > best_partial.num_of_covered) {
+            best_partial = result;
+        }
+        if (program != nullptr && searched_program == nullptr) {
 #ifdef DEBUG
-                    cout << "Find condition " << cond << endl;
+            cout << (index < split_offset ? "Term search" : "Split " + to_string(index - split_offset)) << " found " << program->to_string() << endl;
 #endif
-                    string tcase = search_node(search_time_for_terms_in_seconds, search_time_for_predicates_in_seconds, node->left);
-                    if (tcase != "") {
-                        string fcase = search_node(search_time_for_terms_in_seconds, search_time_for_predicates_in_seconds, node->right);
-                        if (fcase != "") {
-                            searched_program = "(if " + cond + " then " + tcase + " else " + fcase + ")";
-                        }
-                        else {
+            winner = index - split_offset;
+            searched_program = program;
+        }
+        if (index < split_offset && searched_program == nullptr && candidates.empty()) {
 #ifdef DEBUG
-                            cout << "Search fcase failed" << endl;
+            cout << "Failed, try to split node: " << endl;
 #endif
-                        }
-                    }
-                    else {
+            for (auto &result : _pool->submit_in_order(make_split_modes())) {
+                results.push_back(move(result));
+            }
+        }
+    }
+    
+    /* keep the winning split, drop the others */
+    for (int mode = 0; mode < candidates.size(); mode++) {
+        if (mode == winner) {
+            node->labels = candidates[mode]->labels;
+            node->left = candidates[mode]->left;
+            node->right = candidates[mode]->right;
+            candidates[mode]->left = nullptr;
+            candidates[mode]->right = nullptr;
+        }
+        delete_input_output_tree_node(candidates[mode]);
+    }
+    
+    node->program = searched_program;
+    node->searched_program = (searched_program != nullptr) ? searched_program->to_string() : "";
+    
+    /* anytime mode: the program correct on the most examples of the node */
+    if (searched_program != nullptr) {
+        node->partial_program = searched_program;
+        node->num_of_covered = node->example_ids.size();
+    } else if (best_partial.num_of_covered > node->num_of_covered) {
+        /* the root is searched again by every budget round, keep its best partial program */
+        node->partial_program = best_partial.partial_program;
+        node->num_of_covered = best_partial.num_of_covered;
+    }
+    
+    return searched_program;
+}
+
+search_result_t unification::search_split_node(int search_time_for_terms_in_seconds,
+                                         int search_time_for_predicates_in_seconds,
+                                         input_output_tree_node* node,
+                                         shared_ptr<searchControl> search_control) {
+    search_result_t result;
+    BaseType* cond = search_node_one_pass(search_time_for_predicates_in_seconds, node, search_control);
+    if (cond == nullptr) {
 #ifdef DEBUG
-                        cout << "Search tcase failed" << endl;
+        cout << "Search condition, faild" << endl;
 #endif
-                    }
-                }
-                else {
+        return result;
+    }
 #ifdef DEBUG
-                    cout << "faild" << endl;
+    cout << "Find condition " << cond->to_string() << endl;
 #endif
-                }
-            }
-            else {
+    
+    /* the branches are independent, search them in parallel and stop both once one fails */
+    shared_ptr<searchControl> branch_control = make_shared<searchControl>(search_control);
+    vector<input_output_tree_node*> branches = {node->left, node->right};
+    vector<future<BaseType*>> results;
+    for (auto branch : branches) {
+        results.push_back(_pool->submit<BaseType*>([this, search_time_for_terms_in_seconds, search_time_for_predicates_in_seconds, branch, branch_control]() -> BaseType* {
+            BaseType* program = search_node(search_time_for_terms_in_seconds, search_time_for_predicates_in_seconds, branch, branch_control);
+            /* stop the other branch from here, the waiting thread may be running it,
+               in anytime mode it still improves the partial program */
+            if (program == nullptr && !_is_anytime) branch_control->cancel();
+            return program;
+        }));
+    }
+    
+    vector<BaseType*> cases(branches.size(), nullptr);
+    bool is_branch_failed = false;
+    int index;
+    while ((index = _pool->wait_any(results)) != -1) {
+        cases[index] = results[index].get();
+        if (cases[index] == nullptr && !is_branch_failed) {
 #ifdef DEBUG
-                cout << "Split current node, failed" << endl;
+            cout << "Search " << (index == 0 ? "tcase" : "fcase") << " failed" << endl;
 #endif
-                searched_program = "";
-            }
-            if (searched_program != "") {
-                break;
-            }
-            if (is_split_succeed) {
-                backtracing(node);
-            }
+            is_branch_failed = true;
         }
     }
     
-    node->searched_program = searched_program;
+    if (!is_branch_failed) {
+        Ite* ite = new Ite(dynamic_cast<BoolType*>(cond), dynamic_cast<IntType*>(cases[0]), dynamic_cast<IntType*>(cases[1]), true);
+        _result_arena->add(ite);
+        result.program = ite;
+        return result;
+    }
     
-    return searched_program;
+    /* the condition routes the examples exactly, so the branch coverages add up */
+    if (_is_anytime && node->left->partial_program != nullptr && node->right->partial_program != nullptr) {
+        Ite* ite = new Ite(dynamic_cast<BoolType*>(cond), dynamic_cast<IntType*>(node->left->partial_program), dynamic_cast<IntType*>(node->right->partial_program), true);
+        _result_arena->add(ite);
+        result.partial_program = ite;
+        result.num_of_covered = node->left->num_of_covered + node->right->num_of_covered;
+    }
+    return result;
+}
+
+void unification::set_anytime(int deadline_in_seconds) {
+    _is_anytime = true;
+    _search_control = make_shared<searchControl>(deadline_in_seconds, _search_control);
+}
+
+void unification::set_budget_scheduler(budgetScheduler* budget_scheduler) {
+    _budget_scheduler = budget_scheduler;
+}
+
+void unification::interrupt() {
+    _search_control->cancel();
+}
+
+void unification::set_search_control(shared_ptr<searchControl> search_control) {
+    _search_control = make_shared<searchControl>(search_control);
+}
+
+void unification::set_progress_callback(progress_callback_t progress_callback) {
+    _progress_callback = progress_callback;
+}
+
+search_progress_t unification::get_progress() {
+    lock_guard<mutex> lock(_progress_mutex);
+    _progress.elapsed_seconds = chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+    return _progress;
+}
+
+void unification::report_progress(bool is_found, const search_profile_t& profile) {
+    lock_guard<mutex> lock(_progress_mutex);
+    _profile.merge(profile);
+    _progress.num_of_searches++;
+    if (is_found) _progress.num_of_found++;
+    _progress.elapsed_seconds = chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+    if (_progress_callback) _progress_callback(_progress);
 }
 
 string unification::search(int search_time_for_terms_in_seconds, int search_time_for_predicates_in_seconds) {
@@ -241,7 +493,24 @@ string unification::search(int search_time_for_terms_in_seconds, int search_time
     input_outputs_t left_input_outputs;
     input_outputs_t rightInputOutputs;
     
-    return search_node(search_time_for_terms_in_seconds, search_time_for_predicates_in_seconds, _input_output_tree);
+    if (_budget_scheduler == nullptr) {
+        BaseType* searched_program = search_node(search_time_for_terms_in_seconds, search_time_for_predicates_in_seconds, _input_output_tree, _search_control);
+        return (searched_program != nullptr) ? searched_program->to_string() : "";
+    }
+    
+    /* short budgets first, the memo answers what earlier rounds settled and suspended searches are extended */
+    BaseType* searched_program = nullptr;
+    int term_budget, predicate_budget, num_of_repeats;
+    while (searched_program == nullptr && !_search_control->is_stopped() &&
+           _budget_scheduler->next_round(&term_budget, &predicate_budget, &num_of_repeats)) {
+#ifdef DEBUG
+        cout << "Budget round: terms " << term_budget << " predicates " << predicate_budget << " repeat " << num_of_repeats << endl;
+#endif
+        _split_candidate_offset = num_of_repeats * _num_of_split_candidates;
+        searched_program = search_node(term_budget, predicate_budget, _input_output_tree, _search_control);
+    }
+    _split_candidate_offset = 0;
+    return (searched_program != nullptr) ? searched_program->to_string() : "";
 #ifdef DEBUG
     cout << "--------------------------------------" << endl;
 #endif
@@ -252,6 +521,10 @@ string unification::search(int search_time_for_terms_in_seconds, int search_time
  */
 void unification::dump_language_defination() {
     cout << "Language used in Unification:" << endl;
+    cout << "    Predicate backend: " << _predicate_backend << endl;
+    cout << "    Split strategies: ";
+    for (auto strategy : _split_strategies) cout << strategy->get_name() << " ";
+    cout << endl;
     
     cout << "    Predicate language:" << endl;
     cout << "        program depth bound: " << _depth_bound_for_predicate << endl;
@@ -285,202 +558,217 @@ void unification::dump_language_defination() {
 }
 
 /*
-   Split inputoutput example to subsets, different split methods:
-    (1) Split half and half
-    (2) Split by freqency
-*/
-bool unification::split_input_output_tree_node(input_output_tree_node* node, int split_mode) {
-    
-    vector<int> outputs;
-    for (auto ioe : node->input_outputs) {
-        outputs.push_back(ioe["_out"]);
+ Propose a split of the node by every strategy, drop the duplicates and rank
+ the others by how well cheap Lt atoms separate them
+ */
+vector<example_split_t> unification::propose_splits(input_output_tree_node* node) {
+    vector<example_split_t> splits;
+    set<pair<vector<int>, bool>> seen_splits;
+    for (auto strategy : _split_strategies) {
+        example_split_t split;
+        if (!strategy->split(_example_table, _split_atoms, node->example_ids, &split)) continue;
+        if (split.left_example_ids.empty() || split.right_example_ids.empty()) continue;
+        
+        vector<int> left_example_ids = split.left_example_ids;
+        sort(left_example_ids.begin(), left_example_ids.end());
+        if (!seen_splits.insert(make_pair(left_example_ids, split.labels.empty())).second) continue;
+        
+        vector<bool> is_left(node->example_ids.size(), false);
+        for (int i = 0; i < node->example_ids.size(); i++) {
+            is_left[i] = binary_search(left_example_ids.begin(), left_example_ids.end(), node->example_ids[i]);
+        }
+        split.score = _split_atoms->score_separability(node->example_ids, is_left);
+        splits.push_back(split);
     }
+    stable_sort(splits.begin(), splits.end(), [](const example_split_t& a, const example_split_t& b) { return a.score > b.score; });
     
-#ifdef DEBUG
-    cout << "Current node size " << outputs.size() << " ";
-#endif
-    
-    if (outputs.size() < 2) {
-        return false;
+    /* every candidate recurses on its own, keep only the best ranked ones */
+    if (_split_candidate_offset > 0 && !splits.empty()) {
+        rotate(splits.begin(), splits.begin() + (_split_candidate_offset % splits.size()), splits.end());
     }
-    
-    sort(outputs.begin(), outputs.end());
-    
-    /* half and half split */
-    if (split_mode == 0) {
-        bool splitFlag = false;
-        bool allSameValue = false;
-        size_t half_size = outputs.size() / 2;
-    
-        //cout << "splitFlag " << splitFlag << " half_size " << half_size << endl;
-        /* Check if there is -1 in outputs. If there is,
-         (1) split -1 into a group and others in the other group
-         (2) if all -1, split half and half
-         */
-        if (outputs.front() == 0) {
-            if (outputs.back() == 0) {
-                half_size = outputs.size() / 2;
-                splitFlag = true;
-                allSameValue = true;
-            } else {
-                half_size = 0;
-                while(half_size < outputs.size() && outputs[half_size] == 0) {
-                    half_size++;
-                }
-                splitFlag = true;
-            }
-        }
-    
-        //cout << "splitFlag " << splitFlag << " half_size " << half_size << endl;
-        /* Find split size, split into half size first, try grow first half */
-        if (splitFlag == false) {
-            half_size = outputs.size() / 2;
-            while (half_size >= 1 && half_size < outputs.size() && outputs[half_size - 1] == outputs[half_size]) {
-                half_size++;
-            }
-            if (half_size != 0 && half_size != outputs.size()) {
-                splitFlag = true;
-            }
-        }
-    
-        //cout << "splitFlag " << splitFlag << " half_size " << half_size << endl;
-        /* if grow first half failed, try grow second half */
-        if (splitFlag == false) {
-            half_size = outputs.size() / 2;
-            while (half_size >= 1 && half_size < outputs.size() && outputs[half_size - 1] == outputs[half_size]) {
-                half_size--;
-            }
-            if (half_size != 0 && half_size != outputs.size()) {
-                splitFlag = true;
-            }
-        }
-    
-        //cout << "splitFlag " << splitFlag << " half_size " << half_size << endl;
-        /* all same value but not -1 */
-        if (splitFlag == false) {
-            half_size = outputs.size() / 2;
-            allSameValue = true;
-        }
-    
-        //cout << "splitFlag " << splitFlag << " half_size " << half_size << endl;
-        /* found split size, do the split */
-        input_outputs_t left_input_outputs;
-        input_outputs_t rightInputOutputs;
-        if (allSameValue == true) {
-            for (int i = 0; i < half_size; i++) {
-                left_input_outputs.push_back(node->input_outputs[i]);
-            }
-            for (int i = half_size; i < node->input_outputs.size(); i++) {
-                rightInputOutputs.push_back(node->input_outputs[i]);
-            }
-        } else {
-            for (auto &ioe : node->input_outputs) {
-                if (ioe["_out"] <= outputs[half_size-1]) {
-                    left_input_outputs.push_back(ioe);
-                    ioe["_out"] = true;
-                } else {
-                    rightInputOutputs.push_back(ioe);
-                    ioe["_out"] = false;
-                }
-            }
-        }
+    if (splits.size() > _num_of_split_candidates) splits.resize(_num_of_split_candidates);
+
 #ifdef DEBUG
-        cout << "Split to two: left size " << left_input_outputs.size() << " right size " << rightInputOutputs.size() << endl;
-        cout << "LeftOut: [";
-        for (auto ioe : left_input_outputs) {
-            cout << ioe["_out"] << " ";
-        }
-        cout << "]" << endl;
-        cout << "RightOut: [";
-        for (auto ioe : rightInputOutputs) {
-            cout << ioe["_out"] << " ";
-        }
-        cout << "]" << endl;
+    cout << "Split candidates:";
+    for (auto split : splits) cout << " " << split.strategy << " (" << split.score << ")";
+    cout << endl;
 #endif
-        node->left = new input_output_tree_node(left_input_outputs);
-        node->right = new input_output_tree_node(rightInputOutputs);
+    return splits;
+}
+
+
+/*
+ Memo of searched subproblems
+ */
+subproblem_key_t unification::make_subproblem_key(input_output_tree_node* node, bool is_predicate) {
+    subproblem_key_t key;
+    key.is_predicate = is_predicate;
+    vector<int> outputs = get_node_outputs(node, is_predicate);
+    for (int i = 0; i < node->example_ids.size(); i++) {
+        key.labelled_examples.push_back(make_pair(node->example_ids[i], outputs[i]));
+    }
+    sort(key.labelled_examples.begin(), key.labelled_examples.end());
+    return key;
+}
+
+vector<int> unification::get_node_outputs(input_output_tree_node* node, bool is_predicate) {
+    if (is_predicate && !node->labels.empty()) return node->labels;
+    return _example_table->get_outputs(node->example_ids);
+}
+
+bool unification::lookup_subproblem(const subproblem_key_t& key, int time_bound_in_seconds, BaseType** program) {
+    unique_lock<mutex> lock(_subproblem_memo_mutex);
+    auto it = _subproblem_memo.find(key);
+    if (it == _subproblem_memo.end()) return false;
+    if (it->second.program != nullptr) {
+        *program = it->second.program;
         return true;
     }
-    /* frequent based spliting */
-    else if (split_mode == 1) {
-        /* find the most frequent appearing output */
-        int maxCnt = 0;
-        int mostFreqOut = -1;
-        int currCnt = 0;
-        int prevOut = -7; // some number will never appear in the output
-        for (auto out : outputs) {
-            if (out != prevOut) {
-                currCnt = 0;
-            }
-            currCnt++;
-            if (currCnt > maxCnt) {
-                maxCnt = currCnt;
-                mostFreqOut = out;
-            }
-            prevOut = out;
-        }
-        
-        /* do the split */
-        input_outputs_t left;
-        input_outputs_t right;
-        if (maxCnt == 1) {
-            left.push_back(node->input_outputs.front());
-            for (auto ioe : node->input_outputs) {
-                if (ioe != node->input_outputs.front()) {
-                    right.push_back(ioe);
-                }
-            }
-#ifdef DEBUG
-            cout << "Split to two: left size " << left.size() << " right size " << right.size() << endl;
-#endif
+    /* a failure only answers searches with no larger budget */
+    if (time_bound_in_seconds <= it->second.failed_within_seconds) {
+        *program = nullptr;
+        return true;
+    }
+    return false;
+}
+
+void unification::record_subproblem(const subproblem_key_t& key, int time_bound_in_seconds, BaseType* program) {
+    unique_lock<mutex> lock(_subproblem_memo_mutex);
+    auto it = _subproblem_memo.find(key);
+    if (it == _subproblem_memo.end()) {
+        _subproblem_memo[key] = {program, (program == nullptr) ? time_bound_in_seconds : 0};
+    } else if (it->second.program == nullptr) {
+        if (program != nullptr) {
+            it->second.program = program;
         } else {
-            for (auto ioe : node->input_outputs) {
-                if (ioe["_out"] == mostFreqOut) {
-                    left.push_back(ioe);
-                } else {
-                    right.push_back(ioe);
-                }
-            }
-#ifdef DEBUG
-            cout << "Split to two: left size " << left.size() << " right size " << right.size() << endl;
-#endif
+            it->second.failed_within_seconds = max(it->second.failed_within_seconds, time_bound_in_seconds);
         }
-        node->left = new input_output_tree_node(left);
-        node->right = new input_output_tree_node(right);
-        
-        return true;
-    } else {
-        return false;
     }
 }
 
 /*
- backtracing, merget split node
+ Suspended searches and checkpoints
  */
-void unification::backtracing(input_output_tree_node* node) {
-    node->input_outputs.clear();
+bottomUpSearch* unification::resume_search(const subproblem_key_t& key, bottomUpSearch* fresh_search) {
+    suspended_search_t suspended;
+    {
+        unique_lock<mutex> lock(_suspended_searches_mutex);
+        auto it = _suspended_searches.find(key);
+        if (it == _suspended_searches.end()) return fresh_search;
+        suspended = it->second;
+        _suspended_searches.erase(it);
+    }
+    
+    if (suspended.search != nullptr) {
+        delete fresh_search;
+        return suspended.search;
+    }
     
-    if (node != nullptr && node->left != nullptr) {
-        for (auto ioe : node->left->input_outputs) {
-            node->input_outputs.push_back(ioe);
+    /* a checkpoint the search can not be restored from is only a missed shortcut */
+    istringstream in(suspended.checkpoint);
+    try {
+        fresh_search->load_checkpoint(in);
+    } catch (const runtime_error& e) {
+        cerr << "Ignore checkpoint: " << e.what() << endl;
+    }
+    return fresh_search;
+}
+
+void unification::suspend_search(const subproblem_key_t& key, bottomUpSearch* search) {
+    unique_lock<mutex> lock(_suspended_searches_mutex);
+    if (_suspended_searches.size() >= _max_suspended_searches || _suspended_searches.count(key) > 0) {
+        delete search;
+        return;
+    }
+    _suspended_searches[key] = {search, ""};
+}
+
+void unification::set_checkpoint(string checkpoint_file) {
+    _checkpoint_file = checkpoint_file;
+    
+    ifstream in(checkpoint_file);
+    if (!in.is_open()) return;
+    
+    string line, tag;
+    int num_of_examples;
+    getline(in, line);
+    istringstream header(line);
+    if (!(header >> tag >> tag >> num_of_examples) || num_of_examples != _example_table->size()) {
+        throw runtime_error("Checkpoint " + checkpoint_file + " was not written for this input-output file");
+    }
+    
+    /* each search: its subproblem, then the lines of its own checkpoint */
+    while (getline(in, line)) {
+        istringstream search_line(line);
+        subproblem_key_t key;
+        int num_of_lines, num_of_labelled_examples;
+        if (!(search_line >> tag >> key.is_predicate >> num_of_lines >> num_of_labelled_examples) || tag != "search") {
+            throw runtime_error("Malformed checkpoint " + checkpoint_file);
+        }
+        for (int i = 0; i < num_of_labelled_examples; i++) {
+            pair<int, int> example;
+            search_line >> example.first >> example.second;
+            key.labelled_examples.push_back(example);
         }
-        node->left->input_outputs.clear();
-        delete(node->left);
+        
+        string checkpoint;
+        for (int i = 0; i < num_of_lines && getline(in, line); i++) {
+            checkpoint += line + "\n";
+        }
+        _suspended_searches[key] = {nullptr, checkpoint};
     }
-    if (node != nullptr && node->right != nullptr) {
-        for (auto ioe : node->right->input_outputs) {
-            node->input_outputs.push_back(ioe);
+}
+
+void unification::save_checkpoint() {
+    if (_checkpoint_file == "") return;
+    
+    ofstream out(_checkpoint_file);
+    if (!out.is_open()) throw runtime_error("Can not write checkpoint " + _checkpoint_file);
+    out << "unification checkpoint " << _example_table->size() << endl;
+    for (auto suspended : _suspended_searches) {
+        string checkpoint = suspended.second.checkpoint;
+        if (suspended.second.search != nullptr) {
+            ostringstream search_out;
+            suspended.second.search->save_checkpoint(search_out);
+            checkpoint = search_out.str();
         }
-        node->right->input_outputs.clear();
-        delete(node->right);
+        
+        const subproblem_key_t& key = suspended.first;
+        out << "search " << key.is_predicate << " " << count(checkpoint.begin(), checkpoint.end(), '\n') << " " << key.labelled_examples.size();
+        for (auto example : key.labelled_examples) out << " " << example.first << " " << example.second;
+        out << endl << checkpoint;
     }
-    node->left = nullptr;
-    node->right = nullptr;
+}
+
+void unification::delete_input_output_tree_node(input_output_tree_node* node) {
+    if (node == nullptr) return;
+    delete_input_output_tree_node(node->left);
+    delete_input_output_tree_node(node->right);
+    delete node;
 }
 
 /*
 Dumping funcions
 */
+search_profile_t unification::get_profile() {
+    lock_guard<mutex> lock(_progress_mutex);
+    return _profile;
+}
+
+unification_shape_t unification::get_tree_shape() {
+    unification_shape_t shape;
+    function<void(input_output_tree_node*, int)> visit = [&](input_output_tree_node* node, int depth) {
+        if (node == nullptr) return;
+        shape.num_of_nodes++;
+        shape.depth = max(shape.depth, depth);
+        if (node->left == nullptr && node->right == nullptr) shape.num_of_leaves++;
+        visit(node->left, depth + 1);
+        visit(node->right, depth + 1);
+    };
+    visit(_input_output_tree, 0);
+    return shape;
+}
+
 void unification::dump_input_output_tree() {
     cout << "--------------------------------------, dump tree after search" << endl;
     dump_input_output_tree_node(_input_output_tree, "");
@@ -489,14 +777,14 @@ void unification::dump_input_output_tree() {
 
 void unification::dump_input_output_tree_node(input_output_tree_node* node, string space) {
     if (node != nullptr) {
-        for (auto ioe : node->input_outputs) {
+        vector<string> vars = _example_table->get_vars();
+        vector<int> outputs = get_node_outputs(node, true);
+        for (int i = 0; i < node->example_ids.size(); i++) {
             cout << space;
-            for (auto var_value : ioe) {
-                if (var_value.first != "_out") {
-                    cout << var_value.first << " " << var_value.second << " ";
-                }
+            for (int column = 0; column < vars.size(); column++) {
+                cout << vars[column] << " " << _example_table->get_value(column, node->example_ids[i]) << " ";
             }
-            cout << "_out " << ioe["_out"] << endl;
+            cout << "_out " << outputs[i] << endl;
         }
         
         dump_input_output_tree_node(node->left, space + "L---");
@@ -504,20 +792,42 @@ void unification::dump_input_output_tree_node(input_output_tree_node* node, stri
     }
 }
 
-void unification::dump_searched_program() {
+void unification::dump_searched_program(ostream& out) {
 #ifdef DEBUG
     cout << "--------------------------------------, dump search result start" << endl;
 #endif
     if (_input_output_tree != nullptr && _input_output_tree->searched_program != "") {
-        cout << "Searched Program (^0^) : " << _input_output_tree->searched_program << endl;
+        out << "Searched Program (^0^) : " << _input_output_tree->searched_program << endl;
     } else {
-        cout << "Not yet found, (T^T)" << endl;
+        out << "Not yet found, (T^T)" << endl;
+        if (_is_anytime && _input_output_tree != nullptr && _input_output_tree->partial_program != nullptr) {
+            int num_of_examples = _input_output_tree->example_ids.size();
+            out << "Partial Program (^-^) : " << _input_output_tree->partial_program->to_string() << endl;
+            out << "Coverage : " << _input_output_tree->num_of_covered << " / " << num_of_examples << " examples ("
+                 << fixed << setprecision(2) << 100.0 * _input_output_tree->num_of_covered / num_of_examples << "%)" << endl;
+        }
     }
 #ifdef DEBUG
     cout << "--------------------------------------" << endl;
 #endif
 }
 
+BaseType* unification::get_program() {
+    return (_input_output_tree != nullptr) ? _input_output_tree->program : nullptr;
+}
+
+BaseType* unification::get_partial_program() {
+    return (_input_output_tree != nullptr) ? _input_output_tree->partial_program : nullptr;
+}
+
+int unification::get_num_of_covered() {
+    return (_input_output_tree != nullptr) ? _input_output_tree->num_of_covered : 0;
+}
+
+void unification::move_programs_to(programArena* arena) {
+    arena->adopt(_result_arena);
+}
+
 string unification::get_searched_program() {
     if (_input_output_tree != nullptr && _input_output_tree->searched_program != "") {
         return "Searched Program (^0^) : " + _input_output_tree->searched_program;
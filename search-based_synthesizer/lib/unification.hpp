@@ -2,29 +2,75 @@
 #define UNIFICATION_H
 
 #include "bottomUpSearch.hpp"
+#include "budgetScheduler.hpp"
+#include "exampleTable.hpp"
+#include "predicateLearner.hpp"
+#include "programBank.hpp"
+#include "searchControl.hpp"
+#include "splitStrategy.hpp"
+#include "threadPool.hpp"
 #include "typeDef.hpp"
 #include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <set>
+#include <unordered_map>
 #include <vector>
-#include <unistd.h>
 #include <sstream>
-#include <sys/types.h>
-#include <sys/wait.h>
 
 //#define DEBUG
 
 struct input_output_tree_node {
-    input_outputs_t input_outputs;
+    vector<int> example_ids;        // rows of the file's example table
+    vector<int> labels;             // predicate labels when the split relabels the outputs, empty otherwise
     string searched_program;
+    BaseType* program;
+    BaseType* partial_program;      // anytime mode: program correct on the most examples of the node
+    int num_of_covered;
     input_output_tree_node *left;
     input_output_tree_node *right;
-    input_output_tree_node() {
-        input_outputs = input_outputs_t();
-        left = nullptr;
-        right = nullptr;
-        searched_program = "";
+    input_output_tree_node(vector<int> ids) : example_ids(ids), searched_program(""), program(nullptr), partial_program(nullptr), num_of_covered(0), left(nullptr), right(nullptr) {}
+};
+
+/* Result of one search: a program correct on all its examples, or in anytime mode the best partial one */
+struct search_result_t {
+    BaseType* program = nullptr;
+    BaseType* partial_program = nullptr;
+    int num_of_covered = 0;
+};
+
+/* A search subproblem: the phase and the (id, output) pairs of its examples, sorted by id */
+struct subproblem_key_t {
+    bool is_predicate;
+    vector<pair<int, int>> labelled_examples;
+    bool operator==(const subproblem_key_t& other) const {
+        return is_predicate == other.is_predicate && labelled_examples == other.labelled_examples;
+    }
+};
+
+struct subproblem_key_hash_t {
+    size_t operator()(const subproblem_key_t& key) const {
+        size_t h = hash<bool>()(key.is_predicate);
+        for (auto example : key.labelled_examples) {
+            h ^= hash<int>()(example.first * 131 + example.second) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        }
+        return h;
     }
-    input_output_tree_node(input_outputs_t ios) : input_outputs(ios), left(nullptr), right(nullptr), searched_program("") {}
-    input_output_tree_node(input_outputs_t ios, input_output_tree_node *left, input_output_tree_node *right) : input_outputs(ios), left(left), right(right), searched_program("") {}
+};
+
+/* A solved subproblem, or the largest budget it failed within */
+struct subproblem_result_t {
+    BaseType* program;
+    int failed_within_seconds;
+};
+
+/* A search stopped before it finished, alive or as a checkpoint restored on first use */
+struct suspended_search_t {
+    bottomUpSearch* search;
+    string checkpoint;
 };
 
 class unification {
@@ -49,34 +95,103 @@ public:
                 int num_growing_speed,
                 int num_growing_upperbound,
                 
-                input_outputs_t input_outputs);
+                string predicate_backend,
+                vector<string> split_strategies,
+                
+                threadPool* pool,
+                
+                exampleTable* example_table);
+    ~unification();
     
     string search(int search_time_for_terms_in_seconds, int search_time_for_predicates_in_seconds);
     
+    /* anytime mode: stop everything at the deadline and keep the best partial program */
+    void set_anytime(int deadline_in_seconds);
+    
+    /* resume the searches saved in the checkpoint file, and save the unfinished ones back into it */
+    void set_checkpoint(string checkpoint_file);
+    void save_checkpoint();
+    
+    /* run rounds of growing budgets from the scheduler, the search budgets become their caps */
+    void set_budget_scheduler(budgetScheduler* budget_scheduler);
+    
+    /* cancel every running search, e.g. on SIGTERM */
+    void interrupt();
+    
+    /* stop every search when an outer control is cancelled or out of time, set before set_anytime */
+    void set_search_control(shared_ptr<searchControl> search_control);
+    
+    /* report the progress after every finished search, one call at a time from the search threads */
+    void set_progress_callback(progress_callback_t progress_callback);
+    search_progress_t get_progress();
+    
+    /* time spent per phase by the searches so far, and the shape of the tree of the searched program */
+    search_profile_t get_profile();
+    unification_shape_t get_tree_shape();
+    
+    /* searched program, or in anytime mode the best partial one and the examples it is correct on */
+    BaseType* get_program();
+    BaseType* get_partial_program();
+    int get_num_of_covered();
+    
+    /* hand the searched programs to a longer-lived arena, so they outlive the unification */
+    void move_programs_to(programArena* arena);
+    
     /* Dumping fucntions */
     void dump_language_defination();
     void dump_input_output_tree();
-    void dump_searched_program();
+    void dump_searched_program(ostream& out = cout);
     string get_searched_program();
-    
+
 private:
     /* Dumping fucntions */
     void dump_input_output_tree_node(input_output_tree_node* node, string space="");
     
     /* Search node */
-    string search_node_one_pass(int time_bound_in_seconds, input_output_tree_node* node);
-    string search_node(int search_time_for_terms_in_seconds, int search_time_for_predicates_in_seconds, input_output_tree_node* node);
+    BaseType* search_node_one_pass(int time_bound_in_seconds, input_output_tree_node* node, shared_ptr<searchControl> search_control);
+    /* found_control is cancelled as soon as the search finds a program */
+    function<search_result_t()> make_search_node_one_pass(int time_bound_in_seconds, input_output_tree_node* node, shared_ptr<searchControl> search_control,
+                                                          shared_ptr<searchControl> found_control = nullptr);
+    BaseType* search_node(int search_time_for_terms_in_seconds, int search_time_for_predicates_in_seconds, input_output_tree_node* node, shared_ptr<searchControl> search_control);
+    search_result_t search_split_node(int search_time_for_terms_in_seconds, int search_time_for_predicates_in_seconds, input_output_tree_node* node, shared_ptr<searchControl> search_control);
     
-    /* Split current tree node of inputoutput examples */
-    bool split_input_output_tree_node(input_output_tree_node* node, int split_mode);
+    /* Split current tree node of inputoutput examples, best ranked splits first */
+    vector<example_split_t> propose_splits(input_output_tree_node* node);
     
-    /* backtracing, merge the split node */
-    void backtracing(input_output_tree_node* node);
+    /* count a finished search and report the progress */
+    void report_progress(bool is_found, const search_profile_t& profile);
     
-    /* Cluster the input-output examples to subsets for divde-and-conqure */
+    /* free a tree node and its subtrees */
+    void delete_input_output_tree_node(input_output_tree_node* node);
+    
+    /* Memo of searched subproblems */
+    subproblem_key_t make_subproblem_key(input_output_tree_node* node, bool is_predicate);
+    vector<int> get_node_outputs(input_output_tree_node* node, bool is_predicate);
+    bool lookup_subproblem(const subproblem_key_t& key, int time_bound_in_seconds, BaseType** program);
+    void record_subproblem(const subproblem_key_t& key, int time_bound_in_seconds, BaseType* program);
+    
+    /* Suspended searches, resumed instead of restarted when their subproblem comes back */
+    bottomUpSearch* resume_search(const subproblem_key_t& key, bottomUpSearch* fresh_search);
+    void suspend_search(const subproblem_key_t& key, bottomUpSearch* search);
+    
+    /* Cluster the input-output examples to subsets for divde-and-conqure, the table belongs to the caller */
+    exampleTable* _example_table;
     input_output_tree_node* _input_output_tree;
     bool _has_zero_in_ioes = false;
     
+    /* split strategies explored concurrently when a node needs splitting, and the atoms ranking their splits */
+    vector<splitStrategy*> _split_strategies;
+    ltAtomLibrary* _split_atoms;
+    int _split_atom_generation = 2;
+    int _num_of_split_candidates = 2;
+    
+    /* rounds repeating a budget rotate to the next ranked splits */
+    int _split_candidate_offset = 0;
+    budgetScheduler* _budget_scheduler = nullptr;
+    
+    /* start the split modes alongside the term search, only pays off with spare workers */
+    bool _speculative_split;
+    
     /* Language definition for predicates */
     int _depth_bound_for_predicate;
     vector<string> _int_ops_in_predicate;
@@ -101,6 +216,38 @@ private:
     /* num growing configuration */
     int _num_growing_speed;
     int _num_growing_upperbound;
+    
+    /* generations grown into the program banks before searching */
+    int _bank_warm_up_generation = 3;
+    
+    /* predicate search backend: ENUM (bottom up search) or DTREE (decision tree learner) */
+    string _predicate_backend;
+    
+    /* searches run in-process on the pool, with cooperative deadlines */
+    threadPool* _pool;
+    shared_ptr<searchControl> _search_control;
+    
+    bool _is_anytime = false;
+    
+    /* progress of the searches since construction */
+    chrono::steady_clock::time_point _start;
+    search_progress_t _progress;
+    progress_callback_t _progress_callback;
+    search_profile_t _profile;
+    mutex _progress_mutex;
+    
+    /* owns the searched programs and the if-then-else nodes built on them */
+    programArena* _result_arena;
+    
+    /* identical example subsets recur across split modes and depths, remember how their searches ended */
+    unordered_map<subproblem_key_t, subproblem_result_t, subproblem_key_hash_t> _subproblem_memo;
+    mutex _subproblem_memo_mutex;
+    
+    /* searches cancelled by a sibling, or out of time when checkpointing, keep their program lists */
+    unordered_map<subproblem_key_t, suspended_search_t, subproblem_key_hash_t> _suspended_searches;
+    mutex _suspended_searches_mutex;
+    int _max_suspended_searches = 16;
+    string _checkpoint_file = "";
 };
 
 
@@ -1,6 +1,13 @@
 #include "../lib/bottomUpSearch.hpp"
+#include "../lib/coverUnification.hpp"
+#include "../lib/ioeBuilder.hpp"
+#include "../lib/mappedIOEFile.hpp"
+#include "../lib/multiTargetSearch.hpp"
 #include "../lib/unification.hpp"
+#include "../lib/resultCache.hpp"
 #include "../lib/sampler.hpp"
+#include "../lib/synthesisServer.hpp"
+#include "../lib/synthesizer.hpp"
 #include "../lib/typeDef.hpp"
 #include <vector>
 #include <future>
@@ -10,12 +17,47 @@
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <csignal>
+#include <iomanip>
+#include <filesystem>
 using namespace std;
 
 //#define DEBUG
 
+/* control of the running synthesis, cancelled on SIGTERM so its unfinished searches can be checkpointed */
+static shared_ptr<searchControl> sigterm_control = nullptr;
+
+void interrupt_on_sigterm(int signal) {
+    if (sigterm_control != nullptr) sigterm_control->cancel();
+}
+
+/* outcomes of earlier runs, shared by the files of a run */
+static resultCache* result_cache = nullptr;
+
+/* the running server, stopped on SIGTERM */
+static synthesisServer* running_server = nullptr;
+
+void stop_on_sigterm(int signal) {
+    if (running_server != nullptr) running_server->stop();
+}
+
+/* bench name and reference id from an IOE file name, <bench>_..refsrc_<ref id>_... */
+void parse_file_name(string file_name, string* bench_name, int* ref_id) {
+    string tmp = file_name.substr(file_name.rfind("/") + 1);
+    if (tmp.find("_") == string::npos) throw runtime_error("can not extract bench name from file name");
+    *bench_name = tmp.substr(0, tmp.find("_"));
+    if (tmp.find("refsrc_") == string::npos) throw runtime_error("can not extract ref id from file name");
+    tmp = file_name.substr(file_name.rfind("refsrc_") + 7);
+    *ref_id = stoi(tmp.substr(0, tmp.find("_")));
+}
+
 bool parser(int argc, char* argv[],
             string* file_name,
+            vector<string>* multi_target_files,
+            vector<string>* files,
+            vector<string>* parametric_files,
+            string* manifest,
+            string* output_dir,
             int* search_time_for_terms_in_seconds,
             int* search_time_for_predicates_in_seconds,
             int* depth_bound_for_predicate,
@@ -32,8 +74,32 @@ bool parser(int argc, char* argv[],
             string* bench_name,
             int* ref_id,
             int* num_growing_speed,
-            int* num_growing_upperbound) {
+            int* num_growing_upperbound,
+            string* predicate_backend,
+            vector<string>* split_strategies,
+            string* unification_engine,
+            int* anytime_deadline_in_seconds,
+            int* deadline_in_seconds,
+            string* checkpoint_file,
+            string* budget_history_file,
+            string* result_cache_file,
+            vector<string>* convert_files,
+            int* num_threads,
+            string* serve_socket,
+            int* max_requests,
+            double* sampling_rate,
+            string* sampling_strata,
+            bool* is_progressive_sampling,
+            unsigned* sampling_seed,
+            string* output_format,
+            vector<string>* tracers,
+            vector<int>* trace_num_of_bounds,
+            vector<int>* train_sizes,
+            string* cache_config,
+            double* trace_sampling_rate,
+            int* trace_max_num_of_sampled) {
     
+    bool is_num_threads_given = false;
     for (int i = 1; i < argc; i++) {
         
         string argvi(argv[i]);
@@ -43,16 +109,98 @@ bool parser(int argc, char* argv[],
             if (i < argc) {
                 argvi = argv[i];
                 *file_name = argvi;
-                string tmp = argvi.substr(argvi.rfind("/") + 1);
-                if (tmp.find("_") == string::npos) throw runtime_error("can not extract bench name from file name");
-                *bench_name = tmp.substr(0, tmp.find("_"));
-                if (tmp.find("refsrc_") == string::npos) throw runtime_error("can not extract ref id from file name");
-                tmp = argvi.substr(argvi.rfind("refsrc_") + 7);
-                *ref_id = stoi(tmp.substr(0, tmp.find("_")));
+                parse_file_name(argvi, bench_name, ref_id);
                 continue;
             }
             throw runtime_error("-FILE: error in providing file name");
         }
+        else if (argvi == "-FILES") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                while(argvi[0] != '-') {
+                    string files_bench_name;
+                    int files_ref_id;
+                    parse_file_name(argvi, &files_bench_name, &files_ref_id);
+                    if (*bench_name != "" && *bench_name != files_bench_name) {
+                        throw runtime_error("-FILES: files of different benchmarks " + *bench_name + " and " + files_bench_name);
+                    }
+                    *bench_name = files_bench_name;
+                    files->push_back(argvi);
+                    i++;
+                    if (i >= argc) {
+                        break;
+                    }
+                    argvi = argv[i];
+                }
+                i--;
+            } else {
+                throw runtime_error("-FILES: error in providing file names");
+            }
+        }
+        else if (argvi == "-MANIFEST" || argvi == "-DIRECTORY") {
+            i++;
+            if (i < argc) {
+                *manifest = argv[i];
+                continue;
+            }
+            throw runtime_error(argvi + ": error in providing the manifest or directory of IOE files");
+        }
+        else if (argvi == "-OUTPUTDIR") {
+            i++;
+            if (i < argc) {
+                *output_dir = argv[i];
+                continue;
+            }
+            throw runtime_error("-OUTPUTDIR: error in providing output directory");
+        }
+        else if (argvi == "-PARAMETRIC") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                while(argvi[0] != '-') {
+                    string parametric_bench_name;
+                    int parametric_ref_id;
+                    parse_file_name(argvi, &parametric_bench_name, &parametric_ref_id);
+                    if (*bench_name != "" && *bench_name != parametric_bench_name) {
+                        throw runtime_error("-PARAMETRIC: files of different benchmarks " + *bench_name + " and " + parametric_bench_name);
+                    }
+                    *bench_name = parametric_bench_name;
+                    parametric_files->push_back(argvi);
+                    i++;
+                    if (i >= argc) {
+                        break;
+                    }
+                    argvi = argv[i];
+                }
+                i--;
+            } else {
+                throw runtime_error("-PARAMETRIC: error in providing file names");
+            }
+        }
+        else if (argvi == "-MULTITARGET") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                while(argvi[0] != '-') {
+                    string multi_target_bench_name;
+                    parse_file_name(argvi, &multi_target_bench_name, ref_id);
+                    if (*bench_name != "" && *bench_name != multi_target_bench_name) {
+                        throw runtime_error("-MULTITARGET: files of different benchmarks " + *bench_name + " and " + multi_target_bench_name);
+                    }
+                    *bench_name = multi_target_bench_name;
+                    multi_target_files->push_back(argvi);
+                    i++;
+                    if (i >= argc) {
+                        break;
+                    }
+                    argvi = argv[i];
+                }
+                i--;
+            } else {
+                throw runtime_error("-MULTITARGET: error in providing file names");
+            }
+        }
         else if (argvi == "-DEPTHBOUNDPRED") {
             i++;
             if (i < argc) {
@@ -278,222 +426,408 @@ bool parser(int argc, char* argv[],
             }
             throw runtime_error("-NUMGROWUPPERBOUND: error in specifying the upper bound of the constant number");
         }
+        else if (argvi == "-PREDBACKEND") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                if (argvi == "ENUM" || argvi == "DTREE") {
+                    *predicate_backend = argvi;
+                    continue;
+                }
+            }
+            throw runtime_error("-PREDBACKEND: error in specifying the predicate backend (ENUM, DTREE)");
+        }
+        else if (argvi == "-UNIFICATION") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                if (argvi == "SPLIT" || argvi == "COVER") {
+                    *unification_engine = argvi;
+                    continue;
+                }
+            }
+            throw runtime_error("-UNIFICATION: error in specifying the unification engine (SPLIT, COVER)");
+        }
+        else if (argvi == "-SPLITSTRATEGIES") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                while(argvi[0] != '-' && !isdigit(argvi[0])) {
+                    if (argvi != "HALF" && argvi != "FREQUENT" && argvi != "REGION" && argvi != "LINEARREGION" && argvi != "SEPARABLE") {
+                        throw runtime_error("-SPLITSTRATEGIES: unknown split strategy " + argvi);
+                    }
+                    split_strategies->push_back(argvi);
+                    i++;
+                    if (i >= argc) {
+                        break;
+                    }
+                    argvi = argv[i];
+                }
+                i--;
+            } else {
+                throw runtime_error("-SPLITSTRATEGIES: error in specifying the split strategies");
+            }
+        }
+        else if (argvi == "-ANYTIME") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                if (isdigit(argvi[0])) {
+                    *anytime_deadline_in_seconds = stoi(argvi);
+                    continue;
+                }
+            }
+            throw runtime_error("-ANYTIME: error in specifying the anytime deadline");
+        }
+        else if (argvi == "-DEADLINE") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                if (isdigit(argvi[0])) {
+                    *deadline_in_seconds = stoi(argvi);
+                    continue;
+                }
+            }
+            throw runtime_error("-DEADLINE: error in specifying the deadline");
+        }
+        else if (argvi == "-CHECKPOINT") {
+            i++;
+            if (i < argc) {
+                *checkpoint_file = argv[i];
+                continue;
+            }
+            throw runtime_error("-CHECKPOINT: error in providing checkpoint file name");
+        }
+        else if (argvi == "-BUDGETHISTORY") {
+            i++;
+            if (i < argc) {
+                *budget_history_file = argv[i];
+                continue;
+            }
+            throw runtime_error("-BUDGETHISTORY: error in providing budget history file name");
+        }
+        else if (argvi == "-RESULTCACHE") {
+            i++;
+            if (i < argc) {
+                *result_cache_file = argv[i];
+                continue;
+            }
+            throw runtime_error("-RESULTCACHE: error in providing result cache file name");
+        }
+        else if (argvi == "-CONVERTIOE") {
+            if (i + 2 < argc) {
+                convert_files->push_back(argv[i + 1]);
+                convert_files->push_back(argv[i + 2]);
+                i += 2;
+                continue;
+            }
+            throw runtime_error("-CONVERTIOE: error in providing the text and binary IOE file names");
+        }
+        else if (argvi == "-NUMTHREADS") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                if (isdigit(argvi[0])) {
+                    *num_threads = stoi(argvi);
+                    is_num_threads_given = true;
+                    continue;
+                }
+            }
+            throw runtime_error("-NUMTHREADS: error in specifying the number of search threads");
+        }
+        else if (argvi == "-SERVE") {
+            i++;
+            if (i < argc) {
+                *serve_socket = argv[i];
+                continue;
+            }
+            throw runtime_error("-SERVE: error in providing the socket path");
+        }
+        else if (argvi == "-MAXREQUESTS") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                if (isdigit(argvi[0])) {
+                    *max_requests = stoi(argvi);
+                    continue;
+                }
+            }
+            throw runtime_error("-MAXREQUESTS: error in specifying the number of concurrent requests");
+        }
+        else if (argvi == "-SAMPLE") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                if (isdigit(argvi[0]) || argvi[0] == '.') {
+                    *sampling_rate = stod(argvi);
+                    if (*sampling_rate > 0) continue;
+                }
+            }
+            throw runtime_error("-SAMPLE: error in specifying the sampling rate");
+        }
+        else if (argvi == "-SAMPLING") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                while(argvi[0] != '-' && !isdigit(argvi[0])) {
+                    if (argvi == "PROGRESSIVE") {
+                        *is_progressive_sampling = true;
+                    } else if (argvi == "RANDOM" || argvi == "GRID" || argvi == "OUTPUT") {
+                        *sampling_strata = argvi;
+                    } else {
+                        throw runtime_error("-SAMPLING: unknown sampling strata " + argvi);
+                    }
+                    i++;
+                    if (i >= argc) {
+                        break;
+                    }
+                    argvi = argv[i];
+                }
+                i--;
+            } else {
+                throw runtime_error("-SAMPLING: error in specifying the sampling strata");
+            }
+        }
+        else if (argvi == "-SEED") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                if (isdigit(argvi[0])) {
+                    *sampling_seed = stoul(argvi);
+                    continue;
+                }
+            }
+            throw runtime_error("-SEED: error in specifying the sampling seed");
+        }
+        else if (argvi == "-OUTPUTFORMAT") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                if (argvi == "TEXT" || argvi == "JSON") {
+                    *output_format = argvi;
+                    continue;
+                }
+            }
+            throw runtime_error("-OUTPUTFORMAT: error in specifying the output format, TEXT or JSON");
+        }
+        else if (argvi == "-TRACE") {
+            i++;
+            if (i + 1 < argc) {
+                while (i + 1 < argc && argv[i][0] != '-') {
+                    argvi = argv[i + 1];
+                    if (!isdigit(argvi[0])) {
+                        throw runtime_error("-TRACE: error in specifying the number of bounds of " + string(argv[i]));
+                    }
+                    tracers->push_back(argv[i]);
+                    trace_num_of_bounds->push_back(stoi(argvi));
+                    i += 2;
+                }
+                i--;
+            } else {
+                throw runtime_error("-TRACE: error in providing tracers and their numbers of bounds");
+            }
+        }
+        else if (argvi == "-TRAINSIZES") {
+            i++;
+            if (i < argc) {
+                argvi = argv[i];
+                train_sizes->clear();
+                while(isdigit(argvi[0])) {
+                    train_sizes->push_back(stoi(argvi));
+                    i++;
+                    if (i >= argc) {
+                        break;
+                    }
+                    argvi = argv[i];
+                }
+                i--;
+            }
+            if (train_sizes->empty()) throw runtime_error("-TRAINSIZES: error in specifying the train sizes");
+        }
+        else if (argvi == "-CACHECONFIG") {
+            i++;
+            if (i < argc) {
+                *cache_config = argv[i];
+                continue;
+            }
+            throw runtime_error("-CACHECONFIG: error in providing the cache configuration");
+        }
+        else if (argvi == "-TRACESAMPLING") {
+            i++;
+            if (i + 1 < argc) {
+                argvi = argv[i];
+                string max_num_of_sampled = argv[i + 1];
+                if ((isdigit(argvi[0]) || argvi[0] == '.') && isdigit(max_num_of_sampled[0])) {
+                    *trace_sampling_rate = stod(argvi);
+                    *trace_max_num_of_sampled = stoi(max_num_of_sampled);
+                    i++;
+                    if (*trace_sampling_rate > 0 && *trace_max_num_of_sampled > 0) continue;
+                }
+            }
+            throw runtime_error("-TRACESAMPLING: error in specifying the sampling rate and the maximum number of sampled accesses");
+        }
         else {
             throw runtime_error("error in providing command line arguments");
         }
     }
     
+    /* a COVER synthesis runs on one thread, only servers and batches run several of them at once */
+    if (*unification_engine == "COVER" && is_num_threads_given && *serve_socket == "" && *manifest == "" && tracers->empty()) {
+        throw runtime_error("-NUMTHREADS: not with -UNIFICATION COVER, it searches on one thread");
+    }
+    
     return true;
 }
 
 /*
-Language configuration
-*/
-void language_configuration(int* depth_bound_for_predicate,
-                       vector<string>* int_ops_for_predicate,
-                       vector<string>* bool_ops_for_predicate,
-                       vector<string>* vars_in_predicate,
-                       vector<string>* constants_in_predicate,
-                       int* depth_bound_for_term,
-                       vector<string>* int_ops_for_term,
-                       vector<string>* bool_ops_for_term,
-                       vector<string>* vars_in_term,
-                       vector<string>* constants_in_term,
-                       input_outputs_t input_outputs) {
-    
-    if (*depth_bound_for_predicate == -1) {
-        *depth_bound_for_predicate = 6;
-    }
-    /*
-     specify the language u use
-     */
-    if (int_ops_for_predicate->size() == 0) {
-        int_ops_for_predicate->push_back("VAR");
-        int_ops_for_predicate->push_back("NUM");
-        int_ops_for_predicate->push_back("PLUS");
-        //int_ops_for_predicate->push_back("MINUS");
-        int_ops_for_predicate->push_back("TIMES");
-        //int_ops_for_predicate->push_back("ITE");
-    }
-      
-    if (bool_ops_for_predicate->size() == 0) {
-        bool_ops_for_predicate->push_back("F");
-        bool_ops_for_predicate->push_back("AND");
-        bool_ops_for_predicate->push_back("NOT");
-        bool_ops_for_predicate->push_back("LT");
-    }
-    
-    if (constants_in_predicate->size() == 0) {
-        constants_in_predicate->push_back("0");
-        constants_in_predicate->push_back("1");
-        constants_in_predicate->push_back("2");
-        constants_in_predicate->push_back("3");
-        constants_in_predicate->push_back("5");
-        constants_in_predicate->push_back("7");
-        constants_in_predicate->push_back("11");
-        constants_in_predicate->push_back("13");
-        constants_in_predicate->push_back("17");
-        constants_in_predicate->push_back("19");
-        constants_in_predicate->push_back("23");
-        constants_in_predicate->push_back("29");
-        constants_in_predicate->push_back("31");
-        constants_in_predicate->push_back("41");
-        constants_in_predicate->push_back("43");
-        constants_in_predicate->push_back("47");
-        constants_in_predicate->push_back("53");
-    }
-    
-    if (*depth_bound_for_term == -1) {
-        *depth_bound_for_term = 6;
-    }
-    
-    if (int_ops_for_term->size() == 0) {
-        int_ops_for_term->push_back("VAR");
-        int_ops_for_term->push_back("NUM");
-        int_ops_for_term->push_back("PLUS");
-        int_ops_for_term->push_back("TIMES");
-        
-        //int_ops_for_term->push_back("MINUS");
-        //int_ops_for_term->push_back("ITE");
-    }
-    
-    if (constants_in_term->size() == 0) {
-        constants_in_term->push_back("0");
-        constants_in_term->push_back("1");
-        constants_in_term->push_back("2");
-        constants_in_term->push_back("3");
-        constants_in_term->push_back("5");
-        constants_in_term->push_back("7");
-        constants_in_term->push_back("11");
-        constants_in_term->push_back("13");
-        constants_in_term->push_back("17");
-        constants_in_predicate->push_back("19");
-        constants_in_predicate->push_back("23");
-        constants_in_predicate->push_back("29");
-        constants_in_predicate->push_back("31");
-        constants_in_predicate->push_back("41");
-        constants_in_predicate->push_back("43");
-        constants_in_predicate->push_back("47");
-        constants_in_predicate->push_back("53");
-    }
+ Rows of the examples that carry information on where the output changes,
+ filterNonKeyIOEs drops the others. Bound vectors live on a grid of bound value ranks, indexed by flat offset:
+ a bound vector is key if a neighbour at rank distance 1 has another output,
+ and a key vector halfway between two others of the same output is dropped
+ too. Linear in the examples, up to sorting the key vectors per output.
+ */
+vector<int> key_example_ids(exampleTable* table) {
+    int num_of_examples = table->size();
     
-    /*
-     varables are extracted from inputoutput examples
-     */
-    if (!input_outputs.empty()) {
-        for (auto varValue : input_outputs[0]) {
-            if (varValue.first != "_out") {
-                vars_in_predicate->push_back(varValue.first);
-                vars_in_term->push_back(varValue.first);
-            }
-        }
-    }
-    
-    return;
-}
-
-void filterNonKeyIOEs(input_outputs_t* input_outputs) {
     // find the set of bound variables and values
+    vector<string> vars = table->get_vars();
     set<string> bound_vars;
     set<int> bound_value;
-    for (auto ioe : *input_outputs) {
-        for (auto [var, cnt] : ioe) {
-            if (var.find("b") != string::npos) {
-                bound_vars.insert(var);
-                bound_value.insert(cnt);
-            }
+    for (int column = 0; column < vars.size(); column++) {
+        if (vars[column].find("b") != string::npos) {
+            bound_vars.insert(vars[column]);
+            for (int e = 0; e < num_of_examples; e++) bound_value.insert(table->get_value(column, e));
         }
     }
-    map<int, int> bound_value_to_index;
+    unordered_map<int, int> bound_value_to_index;
     int index = 0;
     for (auto v : bound_value) {
         bound_value_to_index[v] = index;
         index++;
     }
+    /* bound variables are read as b0 .. b(m-1), a missing one reads as value 0 */
+    if (bound_value_to_index.find(0) == bound_value_to_index.end()) bound_value_to_index[0] = 0;
     
-    // replace bound variables from values to indices
-    map<vector<int>, int> bound_space;
     int m = bound_vars.size();
-    for (auto ioe : *input_outputs) {
-        vector<int> bound_vec;
-        for (int i = 0; i < m; i++) {
-            bound_vec.push_back(bound_value_to_index[ioe["b" + to_string(i)]]);
-        }
-        bound_space[bound_vec] = ioe["_out"];
-    }
+    vector<int> bound_columns;
+    for (int i = 0; i < m; i++) bound_columns.push_back(table->get_column("b" + to_string(i)));
     
-    // mark non-key ioe in bound_space
-    set<vector<int>> non_key_ioes;
-    for (auto [vec0, value0] : bound_space) {
-        int same_cnt = 0;
-        for (auto [vec1, value1] : bound_space) {
-            int distant = 0;
-            for (int i = 0; i < vec0.size(); i++) {
-                distant += (vec0[i] - vec1[i]) * (vec0[i] - vec1[i]);
-            }
-            if (distant == 1 && value0 != value1)
-                same_cnt++;
-        }
-        if (same_cnt == 0) {
-            non_key_ioes.insert(vec0);
-        }
-    }
+    /* grid of rank vectors, dimension 0 most significant so offsets sort like the vectors */
+    uint64_t radix = max((size_t)1, bound_value.size());
+    vector<uint64_t> strides(m, 1);
+    for (int i = m - 2; i >= 0; i--) strides[i] = strides[i + 1] * radix;
+    uint64_t grid_size = (m == 0) ? 1 : strides[0] * radix;
     
-    map<int, set<vector<int>>> reserved_ioes;
-    auto it = input_outputs->begin();
-    while(it != input_outputs->end()) {
-        auto ioe = *it;
+    /* one cell per distinct bound vector, found by offset in a dense grid or, for a sparse one, a hash table */
+    struct grid_cell_t {
+        uint64_t offset;
         vector<int> bound_vec;
+        int value;
+        bool is_non_key;
+    };
+    vector<grid_cell_t> cells;
+    bool is_dense = (grid_size <= max((uint64_t)1 << 20, (uint64_t)8 * num_of_examples));
+    vector<int> dense_cells(is_dense ? grid_size : 0, -1);
+    unordered_map<uint64_t, int> sparse_cells;
+    auto find_cell = [&](uint64_t offset) -> int {
+        if (is_dense) return dense_cells[offset];
+        auto it = sparse_cells.find(offset);
+        return (it != sparse_cells.end()) ? it->second : -1;
+    };
+    
+    // replace bound variables from values to indices, the last output of a bound vector wins
+    vector<int> example_cells;
+    example_cells.reserve(num_of_examples);
+    for (int e = 0; e < num_of_examples; e++) {
+        vector<int> bound_vec(m);
+        uint64_t offset = 0;
         for (int i = 0; i < m; i++) {
-            bound_vec.push_back(bound_value_to_index[ioe["b" + to_string(i)]]);
+            bound_vec[i] = bound_value_to_index[(bound_columns[i] != -1) ? table->get_value(bound_columns[i], e) : 0];
+            offset += bound_vec[i] * strides[i];
         }
-        if (find(non_key_ioes.begin(), non_key_ioes.end(), bound_vec) == non_key_ioes.end()) {
-            //it = input_outputs->erase(it);
-            //} else {
-            reserved_ioes[ioe["_out"]].insert(bound_vec);
+        int value = table->get_output(e);
+        
+        int cell = find_cell(offset);
+        if (cell == -1) {
+            cell = cells.size();
+            cells.push_back({offset, bound_vec, value, false});
+            if (is_dense) {
+                dense_cells[offset] = cell;
+            } else {
+                sparse_cells[offset] = cell;
+            }
         }
-        ++it;
+        cells[cell].value = value;
+        example_cells.push_back(cell);
     }
     
-    for (auto [out, set_v] : reserved_ioes) {
-        for (int i = 1; i < set_v.size()-1; i++) {
-            auto v1 = *next(set_v.begin(), i-1);
-            auto v2 = *next(set_v.begin(), i);
-            auto v3 = *next(set_v.begin(), i+1);
-            vector<int> diff_v1_v2;
-            vector<int> diff_v2_v3;
-            for (int j = 0; j < v1.size(); j++) {
-                diff_v1_v2.push_back(v2[j]-v1[j]);
-            }
-            for (int j = 0; j < v2.size(); j++) {
-                diff_v2_v3.push_back(v3[j]-v2[j]);
+    // mark non-key ioe: no neighbour at distance 1 with another value
+    for (auto &cell : cells) {
+        bool has_different_neighbour = false;
+        for (int i = 0; i < m && !has_different_neighbour; i++) {
+            if (cell.bound_vec[i] > 0) {
+                int neighbour = find_cell(cell.offset - strides[i]);
+                if (neighbour != -1 && cells[neighbour].value != cell.value) has_different_neighbour = true;
             }
-            if (diff_v1_v2 == diff_v2_v3) {
-                non_key_ioes.insert(v2);
+            if (cell.bound_vec[i] + 1 < (int)radix) {
+                int neighbour = find_cell(cell.offset + strides[i]);
+                if (neighbour != -1 && cells[neighbour].value != cell.value) has_different_neighbour = true;
             }
         }
+        cell.is_non_key = !has_different_neighbour;
     }
     
-    //cout << bound_space.size() << " ";
-    //cout << non_key_ioes.size() << endl;
+    // key vectors per output, sorted, drop the middle of three evenly spaced ones
+    vector<pair<int, uint64_t>> reserved_ioes;
+    for (int e = 0; e < num_of_examples; e++) {
+        int cell = example_cells[e];
+        if (!cells[cell].is_non_key) reserved_ioes.push_back(make_pair(table->get_output(e), cells[cell].offset));
+    }
+    sort(reserved_ioes.begin(), reserved_ioes.end());
+    reserved_ioes.erase(unique(reserved_ioes.begin(), reserved_ioes.end()), reserved_ioes.end());
     
-    it = input_outputs->begin();
-    while(it != input_outputs->end()) {
-        auto ioe = *it;
-        vector<int> bound_vec;
-        for (int i = 0; i < m; i++) {
-            bound_vec.push_back(bound_value_to_index[ioe["b" + to_string(i)]]);
-        }
-        if (find(non_key_ioes.begin(), non_key_ioes.end(), bound_vec) != non_key_ioes.end()) {
-            it = input_outputs->erase(it);
-        } else {
-            ++it;
+    vector<int> evenly_spaced_cells;
+    for (int i = 1; i + 1 < reserved_ioes.size(); i++) {
+        if (reserved_ioes[i - 1].first != reserved_ioes[i].first || reserved_ioes[i + 1].first != reserved_ioes[i].first) continue;
+        const vector<int>& v1 = cells[find_cell(reserved_ioes[i - 1].second)].bound_vec;
+        const vector<int>& v2 = cells[find_cell(reserved_ioes[i].second)].bound_vec;
+        const vector<int>& v3 = cells[find_cell(reserved_ioes[i + 1].second)].bound_vec;
+        bool is_evenly_spaced = true;
+        for (int j = 0; j < m && is_evenly_spaced; j++) {
+            is_evenly_spaced = (v2[j] - v1[j] == v3[j] - v2[j]);
         }
+        if (is_evenly_spaced) evenly_spaced_cells.push_back(find_cell(reserved_ioes[i].second));
     }
+    for (auto cell : evenly_spaced_cells) cells[cell].is_non_key = true;
     
+    vector<int> key_ids;
+    for (int e = 0; e < num_of_examples; e++) {
+        if (!cells[example_cells[e]].is_non_key) key_ids.push_back(e);
+    }
+    return key_ids;
+}
+
+void filterNonKeyIOEs(exampleTable* table) {
+    *table = table->select(key_example_ids(table));
 }
 
-bool readInputOutput(string file_name, input_outputs_t* input_outputs) {
+void filterNonKeyIOEs(input_outputs_t* input_outputs) {
+    exampleTable table(*input_outputs);
+    input_outputs_t key_ioes;
+    for (auto e : key_example_ids(&table)) key_ioes.push_back(move((*input_outputs)[e]));
+    *input_outputs = move(key_ioes);
+}
+
+bool readInputOutput(string file_name, input_outputs_t* input_outputs, bool filter_non_key_ioes = true) {
+    /* binary columnar files are mapped, not parsed */
+    if (mappedIOEFile::is_binary(file_name)) {
+        mappedIOEFile mapped_file(file_name);
+        exampleTable example_table = mapped_file.get_example_table();
+        if (filter_non_key_ioes) filterNonKeyIOEs(&example_table);
+        *input_outputs = example_table.get_input_outputs();
+        return true;
+    }
+    
     ifstream ifs;
     ifs.open(file_name, ifstream::in);
     string line;
@@ -518,37 +852,278 @@ bool readInputOutput(string file_name, input_outputs_t* input_outputs) {
     ifs.close();
     
     //cout << "Resize IOE " << input_outputs->size() << " to ";
-    filterNonKeyIOEs(input_outputs);
+    if (filter_non_key_ioes) filterNonKeyIOEs(input_outputs);
     //cout << input_outputs->size() << endl;
     
     return true;
 }
 
-void writeSearchedProgram(string file_name, string prog) {
-    ofstream ofs;
-    size_t pos = file_name.find("/ris_per_iter_refsrc/");
-    if (pos != string::npos) {
-        pos = file_name.find_last_of("/");
-        string conf = file_name.substr(pos+1, file_name.size());
-        string header = file_name.substr(0, pos);
-        pos = header.find_last_of("/");
-        file_name.replace(0, pos, "./synResult/");
-        file_name.replace(file_name.size() - 4, file_name.size(), "_src.txt");
-        ofs.open(file_name);
-        if (ofs.is_open()) {
-            ofs << conf << " " << prog;
-        }
-        ofs.close();
-    }
-    return;
+/* examples of a file as a table, binary files go from their columns to the table without input-output maps */
+bool readExampleTable(string file_name, exampleTable* example_table, bool filter_non_key_ioes = true) {
+    if (mappedIOEFile::is_binary(file_name)) {
+        mappedIOEFile mapped_file(file_name);
+        *example_table = mapped_file.get_example_table();
+    } else {
+        input_outputs_t input_outputs;
+        if (!readInputOutput(file_name, &input_outputs, false)) return false;
+        *example_table = exampleTable(input_outputs);
+    }
+    if (filter_non_key_ioes) filterNonKeyIOEs(example_table);
+    return true;
+}
+
+/* command line options of a run: the synthesis configuration and the files it runs on */
+struct synthesis_options_t : synthesis_config_t {
+    string file_name = "";
+    vector<string> multi_target_files;
+    vector<string> files;
+    vector<string> parametric_files;
+    string manifest = "";
+    string output_dir = "";
+    string result_cache_file = "";
+    vector<string> convert_files;
+    string serve_socket = "";
+    int max_requests = -1;
+    string output_format = "TEXT";
+    /* files a result is reported for, the file name if empty */
+    vector<string> result_files;
+    /* tracers streaming their reuse records, and the bound vectors they run on */
+    vector<string> tracers;
+    vector<int> trace_num_of_bounds;
+    vector<int> train_sizes = {8, 12, 16, 20};
+    string cache_config = "cls32_ds8";
+    /* source accesses kept per reference, like the IOE generator */
+    double trace_sampling_rate = 0.2;
+    int trace_max_num_of_sampled = 20;
+};
+
+bool parse_options(int argc, char* argv[], synthesis_options_t* options) {
+    return parser(argc, argv,
+                  &options->file_name, &options->multi_target_files, &options->files, &options->parametric_files, &options->manifest, &options->output_dir, &options->search_time_for_terms_in_seconds, &options->search_time_for_predicates_in_seconds,
+                  &options->language.depth_bound_for_predicate, &options->language.int_ops_for_predicate, &options->language.bool_ops_for_predicate, &options->language.vars_in_predicate, &options->language.constants_in_predicate,
+                  &options->language.depth_bound_for_term, &options->language.int_ops_for_term, &options->language.bool_ops_for_term, &options->language.vars_in_term, &options->language.constants_in_term,
+                  &options->language.rules_to_apply,
+                  &options->bench_name, &options->ref_id,
+                  &options->num_growing_speed, &options->num_growing_upperbound,
+                  &options->predicate_backend,
+                  &options->split_strategies,
+                  &options->unification_engine,
+                  &options->anytime_deadline_in_seconds,
+                  &options->deadline_in_seconds,
+                  &options->checkpoint_file,
+                  &options->budget_history_file,
+                  &options->result_cache_file,
+                  &options->convert_files,
+                  &options->num_threads,
+                  &options->serve_socket,
+                  &options->max_requests,
+                  &options->sampling_rate,
+                  &options->sampling_strata,
+                  &options->is_progressive_sampling,
+                  &options->sampling_seed,
+                  &options->output_format,
+                  &options->tracers,
+                  &options->trace_num_of_bounds,
+                  &options->train_sizes,
+                  &options->cache_config,
+                  &options->trace_sampling_rate,
+                  &options->trace_max_num_of_sampled);
+}
+
+/* options of a server request, a command line without the program name, over the options of the server */
+void parse_request_options(const string& request_options, synthesis_config_t* config) {
+    vector<string> tokens = {"symRiSynthesiser"};
+    istringstream ss(request_options);
+    string token;
+    while (ss >> token) tokens.push_back(token);
+    vector<char*> request_argv;
+    for (auto &t : tokens) request_argv.push_back(&t[0]);
+    
+    synthesis_options_t options;
+    static_cast<synthesis_config_t&>(options) = *config;
+    parse_options(request_argv.size(), request_argv.data(), &options);
+    if (!options.multi_target_files.empty() || !options.files.empty() || !options.parametric_files.empty() || options.manifest != "" ||
+        options.checkpoint_file != "" || options.result_cache_file != "" || !options.convert_files.empty() || options.serve_socket != "" || !options.tracers.empty()) {
+        throw runtime_error("Requests take their examples inline, -FILE only names the problem");
+    }
+    *config = options;
+}
+
+/* JSON output: a result is reported for the files it stands for */
+vector<string> result_files(const synthesis_options_t& options) {
+    if (!options.result_files.empty()) return options.result_files;
+    return {options.file_name};
+}
+
+string json_list(const vector<string>& items) {
+    string list = "[";
+    for (int i = 0; i < items.size(); i++) list += ((i > 0) ? "," : "") + json_quote(items[i]);
+    return list + "]";
 }
 
+void dump_error_record(const vector<string>& files, string error, ostream& out) {
+    out << "{\"files\":" << json_list(files) << ",\"found\":false,\"error\":" << json_quote(error) << "}" << endl;
+}
+
+/*
+ Synthesize one problem and dump the result to out, returns "" if no program is found.
+ With a checkpoint, SIGTERM cancels the searches and the unfinished ones are checkpointed.
+ */
+string synthesize_and_dump(synthesis_options_t options, exampleTable* example_table, ostream& out, threadPool* pool = nullptr) {
+    /* outcomes of earlier runs on the same examples and configuration */
+    string problem_hash;
+    if (result_cache != nullptr) {
+        problem_hash = resultCache::problem_hash(options, example_table->get_input_outputs());
+        string cached_program;
+        if (result_cache->lookup(problem_hash, options, &cached_program)) {
+            if (options.output_format == "JSON") {
+                out << "{\"files\":" << json_list(result_files(options)) << ",\"found\":" << ((cached_program != "") ? "true" : "false")
+                    << ",\"program\":" << ((cached_program != "") ? json_quote(cached_program) : "null") << ",\"cached\":true}" << endl;
+            } else if (cached_program != "") {
+                out << "Searched Program (^0^) : " << cached_program << endl;
+            } else {
+                out << "Not yet found, (T^T)" << endl;
+            }
+            return cached_program;
+        }
+    }
+    
+    shared_ptr<searchControl> search_control = make_shared<searchControl>(shared_ptr<searchControl>());
+    if (options.checkpoint_file != "") {
+        sigterm_control = search_control;
+        signal(SIGTERM, interrupt_on_sigterm);
+    }
+    
+    /* the files of a batch run on the pool, a COVER synthesis runs on the thread of its file */
+    if (options.unification_engine == "COVER") pool = nullptr;
+    synthesis_result_t result = synthesize(options, example_table, synthesis_callbacks_t(), search_control, pool);
+    
+    if (options.checkpoint_file != "") {
+        signal(SIGTERM, SIG_DFL);
+        sigterm_control = nullptr;
+    }
+    
+    if (options.output_format == "JSON") {
+        dump_synthesis_result_json(result, result_files(options), out);
+    } else {
+        dump_synthesis_result(result, out);
+    }
+    
+    string searched_program = result.is_found ? result.program->to_string() : "";
+    if (result_cache != nullptr && !result.stats.is_cancelled) {
+        result_cache->record(problem_hash, options, searched_program);
+    }
+    return searched_program;
+}
+
+string synthesize_and_dump(synthesis_options_t options, input_outputs_t input_outputs, ostream& out, threadPool* pool = nullptr) {
+    exampleTable example_table(input_outputs);
+    return synthesize_and_dump(options, &example_table, out, pool);
+}
+
+/*
+ Canonical text of a problem: the reference, then the examples over the
+ columns that vary, sorted. Columns constant within the file, like isrc, are
+ left out, the constant columns and their values are returned apart.
+ */
+string canonicalize_problem(int ref_id, input_outputs_t input_outputs, string* constant_columns) {
+    vector<string> vars;
+    if (!input_outputs.empty()) {
+        for (auto var_value : input_outputs[0]) {
+            if (var_value.first != "_out") vars.push_back(var_value.first);
+        }
+    }
+    
+    vector<string> varying_vars;
+    *constant_columns = "";
+    for (auto var : vars) {
+        bool is_constant = true;
+        for (auto ioe : input_outputs) {
+            if (ioe[var] != input_outputs[0][var]) {
+                is_constant = false;
+                break;
+            }
+        }
+        if (is_constant) {
+            *constant_columns += var + " " + to_string(input_outputs[0][var]) + " ";
+        } else {
+            varying_vars.push_back(var);
+        }
+    }
+    
+    vector<vector<int>> rows;
+    for (auto ioe : input_outputs) {
+        vector<int> row;
+        for (auto var : varying_vars) row.push_back(ioe[var]);
+        row.push_back(ioe["_out"]);
+        rows.push_back(row);
+    }
+    sort(rows.begin(), rows.end());
+    rows.erase(unique(rows.begin(), rows.end()), rows.end());
+    
+    string canonical_problem = "ref " + to_string(ref_id) + " vars";
+    for (auto var : varying_vars) canonical_problem += " " + var;
+    for (auto row : rows) {
+        canonical_problem += "\n";
+        for (auto value : row) canonical_problem += to_string(value) + " ";
+    }
+    return canonical_problem;
+}
+
+/*
+ Merge the examples of the files of one reference into one problem, the isrc
+ columns constant within every file become variables of the merged problem.
+ Returns false if two files disagree on the output of the same inputs.
+ */
+bool merge_problems(vector<input_outputs_t> problems, input_outputs_t* merged_input_outputs) {
+    map<input_output_t, int> outputs;
+    for (auto input_outputs : problems) {
+        for (auto ioe : input_outputs) {
+            if (ioe.find("_out") == ioe.end()) throw runtime_error("No _out entry in IOE");
+            int output = ioe["_out"];
+            ioe.erase("_out");
+            if (!problems[0].empty() && ioe.size() != problems[0][0].size() - 1) {
+                throw runtime_error("Files of one reference have different variables");
+            }
+            auto it = outputs.find(ioe);
+            if (it != outputs.end() && it->second != output) return false;
+            outputs[ioe] = output;
+        }
+    }
+    
+    merged_input_outputs->clear();
+    for (auto input_output : outputs) {
+        input_output_t ioe = input_output.first;
+        ioe["_out"] = input_output.second;
+        merged_input_outputs->push_back(ioe);
+    }
+    return true;
+}
+
+/* the examples without the columns constant within the file */
+input_outputs_t drop_constant_columns(input_outputs_t input_outputs) {
+    string constant_columns;
+    canonicalize_problem(0, input_outputs, &constant_columns);
+    istringstream columns(constant_columns);
+    string var;
+    int value;
+    while (columns >> var >> value) {
+        for (auto &ioe : input_outputs) ioe.erase(var);
+    }
+    return input_outputs;
+}
 
 int main(int argc, char* argv[]) {
     
     if (argc < 2) {
         cout << "Error: command line options:" << endl;
         cout << "      -FILE : specify path with the name of input-output-example file" << endl;
+        cout << "      -FILES : or specify IOE files of one benchmark, equivalent problems are synthesized once" << endl;
+        cout << "      -MANIFEST : or specify a file listing IOE files, one per line, synthesized in one process" << endl;
+        cout << "      -DIRECTORY : or specify a directory of IOE files, synthesized in one process" << endl;
+        cout << "      -OUTPUTDIR : specify where the result of every file is written as <file>.syn, and batch_status.txt of -MANIFEST or -DIRECTORY" << endl;
+        cout << "      -PARAMETRIC : or specify IOE files of one benchmark, the files of a reference are merged into one problem over isrc" << endl;
+        cout << "      -MULTITARGET : or specify IOE files of one benchmark, searched for terms by one enumeration per reference and bound grid, files no term fits are unified one by one" << endl;
         cout << "    Optional specification for predicate language" << endl;
         cout << "      -DEPTHBOUNDPRED : specify the depth of a predicate program" << endl;
         cout << "      -INTOPSPRED : specify the int ops for the predication language" << endl;
@@ -566,98 +1141,442 @@ int main(int argc, char* argv[]) {
         cout << "      -SEARCHTIMEFORPREDSINSECONDS : specify the search time for preds in seconds" << endl;
         cout << "    Optional to sepcify the search rules to apply" << endl;
         cout << "      -RULESTOAPPLY : specify search mode (SrcOnly, SrcEnhanced, SrcSnk)" << endl;
+        cout << "    Optional to specify the predicate search backend (default to ENUM)" << endl;
+        cout << "      -PREDBACKEND : ENUM for bottom up search, DTREE for the decision tree learner over Lt atoms" << endl;
+        cout << "    Optional to specify the unification engine (default to SPLIT)" << endl;
+        cout << "      -UNIFICATION : SPLIT to split examples and search every part, COVER to cover examples by terms and learn guards" << endl;
+        cout << "    Optional to specify the split strategies (default to HALF FREQUENT REGION LINEARREGION SEPARABLE)" << endl;
+        cout << "      -SPLITSTRATEGIES : HALF, FREQUENT, REGION, LINEARREGION or SEPARABLE, ranked by separability at every split" << endl;
+        cout << "    Optional to run in anytime mode (default to off)" << endl;
+        cout << "      -ANYTIME : specify the deadline in seconds, then report the program correct on the most examples if none is found" << endl;
+        cout << "    Optional to checkpoint unfinished searches (default to off)" << endl;
+        cout << "      -CHECKPOINT : specify the checkpoint file, resumed from if it exists and written when no program is found or on SIGTERM" << endl;
+        cout << "    Optional to schedule search budgets from recorded solve times (default to off)" << endl;
+        cout << "      -BUDGETHISTORY : specify the solve time history file, budgets grow in Luby rounds up to the search times above" << endl;
+        cout << "    Optional to convert a text IOE file to the binary columnar format, read by -FILE and the other modes like text files" << endl;
+        cout << "      -CONVERTIOE : specify the text IOE file and the binary IOE file to write, then exit" << endl;
+        cout << "    Optional to reuse the outcomes of earlier runs (default to off)" << endl;
+        cout << "      -RESULTCACHE : specify the result cache file, programs found and failures within larger budgets are not searched again" << endl;
+        cout << "    Optional to specify the number of search threads (default to the number of cores)" << endl;
+        cout << "      -NUMTHREADS : specify the number of threads running searches" << endl;
+        cout << "    Optional to bound the whole synthesis (default to off)" << endl;
+        cout << "      -DEADLINE : specify the deadline in seconds, every search is cancelled when it passes" << endl;
+        cout << "    Optional to run as a synthesis server (default to off)" << endl;
+        cout << "      -SERVE : specify the Unix socket path, then answer framed requests of options and examples until SIGTERM" << endl;
+        cout << "      -MAXREQUESTS : specify the number of requests served at once, further ones are answered Busy (default to the number of threads)" << endl;
+        cout << "    Optional to synthesize on a sample of the examples (default to all of them)" << endl;
+        cout << "      -SAMPLE : specify the sampling rate, the fraction of the examples kept in every stratum" << endl;
+        cout << "      -SAMPLING : RANDOM, GRID for a coarse grid of the bounds or OUTPUT for the output levels (default to GRID), and PROGRESSIVE to grow the sample by the examples the program fails on" << endl;
+        cout << "      -SEED : specify the seed of the sampling (default to 0)" << endl;
+        cout << "    Optional to synthesize straight from tracers built with PROFILE_STREAM (bench/Makefile stream_gen), without CSV or IOE files" << endl;
+        cout << "      -TRACE : specify tracers each followed by its number of bounds, the src_only problems of a tracer are synthesized while the next one runs" << endl;
+        cout << "      -TRAINSIZES : specify the values of every bound, every bound vector is traced (default to 8 12 16 20)" << endl;
+        cout << "      -CACHECONFIG : specify the cache configuration the tracers are built for, in the problem names (default to cls32_ds8)" << endl;
+        cout << "      -TRACESAMPLING : specify the sampling rate of the source accesses and the maximum number sampled over all references (default to 0.2 20)" << endl;
+        cout << "    Optional to specify the output format (default to TEXT)" << endl;
+        cout << "      -OUTPUTFORMAT : TEXT for the program found, JSON for one line per file with the program, the unification tree, the time per search phase, the program list sizes per generation and the peak memory" << endl;
         return 0;
     }
     
     /*
      parse command line
      */
-    string file_name = "";
-    int depth_bound_for_predicate = -1;
-    vector<string> int_ops_for_predicate;
-    vector<string> bool_ops_for_predicate;
-    vector<string> vars_in_predicate;
-    vector<string> constants_in_predicate;
-    int depth_bound_for_term = -1;
-    vector<string> int_ops_for_term;
-    vector<string> bool_ops_for_term;
-    vector<string> vars_in_term;
-    vector<string> constants_in_term;
-    
-    int search_time_for_terms_in_seconds = 20;
-    int search_time_for_predicates_in_seconds = 20;
-    
-    vector<string> rules_to_apply;
-    
-    string bench_name = "";
-    int ref_id = 0;
-    
-    int num_growing_speed = 1;
-    int num_growing_upperbound = 100;
-    
-    if ( parser(argc, argv,
-               &file_name, &search_time_for_terms_in_seconds, &search_time_for_predicates_in_seconds,
-               &depth_bound_for_predicate, &int_ops_for_predicate, &bool_ops_for_predicate, &vars_in_predicate, &constants_in_predicate,
-               &depth_bound_for_term, &int_ops_for_term, &bool_ops_for_term, &vars_in_term, &constants_in_term,
-               &rules_to_apply,
-               &bench_name, &ref_id,
-               &num_growing_speed, &num_growing_upperbound) == false ) {
+    synthesis_options_t options;
+    
+    if (parse_options(argc, argv, &options) == false) {
         cout << "Error in parsing command lines" << endl;
         return 0;
     }
     
-    /*
-     read input output files
-     */
-    input_outputs_t input_outputs;
-    if (!readInputOutput(file_name, &input_outputs)) {
-        cout << "Error reading files" << endl;
+    /* converter from the text IOE format */
+    if (!options.convert_files.empty()) {
+        mappedIOEFile::convert(options.convert_files[0], options.convert_files[1]);
+        mappedIOEFile converted_file(options.convert_files[1]);
+        cout << "Converted : " << options.convert_files[0] << " to " << options.convert_files[1] << ", " << converted_file.size() << " examples" << endl;
+        return 0;
+    }
+    
+    if (options.result_cache_file != "") {
+        result_cache = new resultCache(options.result_cache_file);
+    }
+    
+    /* server: requests share the pool, the program banks and the found programs until SIGTERM */
+    if (options.serve_socket != "") {
+        if (options.checkpoint_file != "") throw runtime_error("-CHECKPOINT: only with a single -FILE");
+        int max_requests = (options.max_requests > 0) ? options.max_requests : options.num_threads;
+        synthesisServer* server = new synthesisServer(options.serve_socket, options, parse_request_options, max_requests);
+        running_server = server;
+        signal(SIGTERM, stop_on_sigterm);
+        signal(SIGINT, stop_on_sigterm);
+        cout << "Serving on " << options.serve_socket << endl;
+        server->serve();
+        running_server = nullptr;
+        delete server;
         return 0;
     }
     
-    /* sample inputouput Files */
-    //sampler s(0.1);
-    //input_outputs = s.randomSampling(input_outputs);
+    /* multi-target term search over many files, every file is read whole so that they share the bound grid */
+    if (!options.multi_target_files.empty()) {
+        if (options.sampling_rate < 1) throw runtime_error("-SAMPLE: not with -MULTITARGET, every file is read whole");
+        vector<string> multi_target_files = options.multi_target_files;
+        vector<input_outputs_t> multi_target_input_outputs(multi_target_files.size());
+        for (int i = 0; i < multi_target_files.size(); i++) {
+            if (!readInputOutput(multi_target_files[i], &multi_target_input_outputs[i], false)) {
+                if (options.output_format == "JSON") {
+                    dump_error_record({multi_target_files[i]}, "Error reading files", cout);
+                } else {
+                    cout << "Error reading files" << endl;
+                }
+                return 0;
+            }
+        }
+        /* only the operators and constants, every group searches over its own bound variables */
+        language_configuration(&options.language, input_outputs_t());
+        
+        multiTargetSearch* multi_target = new multiTargetSearch(options.language.depth_bound_for_term, options.language.int_ops_for_term, options.language.bool_ops_for_term, options.language.constants_in_term,
+                                                                options.language.rules_to_apply,
+                                                                options.bench_name,
+                                                                options.num_growing_speed, options.num_growing_upperbound);
+        for (int i = 0; i < multi_target_files.size(); i++) {
+            int ref_id;
+            parse_file_name(multi_target_files[i], &options.bench_name, &ref_id);
+            multi_target->add_target(multi_target_files[i], ref_id, multi_target_input_outputs[i]);
+        }
+        multi_target->search(options.search_time_for_terms_in_seconds);
+        
+        /* one result per file, like the other multi-file modes */
+        if (options.output_dir != "") filesystem::create_directories(options.output_dir);
+        ostream& info = (options.output_format == "JSON") ? cerr : cout;
+        int num_of_found = 0;
+        int num_of_unified = 0;
+        for (int i = 0; i < multi_target->get_targets().size(); i++) {
+            const term_target_t& target = multi_target->get_targets()[i];
+            bool is_found = (target.searched_program != "");
+            ostringstream result;
+            if (!target.is_term_target) {
+                /* several outputs on one grid point, no term fits the file, it needs a unification of its own */
+                synthesis_options_t file_options = options;
+                file_options.file_name = target.file_name;
+                file_options.ref_id = target.ref_id;
+                input_outputs_t input_outputs = multi_target_input_outputs[i];
+                filterNonKeyIOEs(&input_outputs);
+                is_found = (synthesize_and_dump(file_options, input_outputs, result) != "");
+                num_of_unified++;
+            } else if (options.output_format == "JSON") {
+                result << "{\"files\":" << json_list({target.file_name}) << ",\"found\":" << (is_found ? "true" : "false")
+                       << ",\"program\":" << (is_found ? json_quote(target.searched_program) : "null") << "}" << endl;
+            } else if (is_found) {
+                result << "Searched Program (^0^) : " << target.searched_program << endl;
+            } else {
+                result << "Not yet found, (T^T)" << endl;
+            }
+            if (is_found) num_of_found++;
+            if (options.output_format == "JSON") {
+                cout << result.str();
+            } else {
+                cout << "File : " << target.file_name << endl << result.str();
+            }
+            if (options.output_dir != "") {
+                ofstream out(options.output_dir + "/" + filesystem::path(target.file_name).filename().string() + ".syn");
+                out << result.str();
+            }
+        }
+        info << "Multi-target : " << num_of_found << " / " << multi_target->get_targets().size() << " files solved by "
+             << multi_target->get_num_of_groups() << " enumerations and " << num_of_unified << " unifications" << endl;
+        
+        delete multi_target;
+        return 0;
+    }
+    
+    /* batch: every file and its unification subtasks run on one pool, programs banks are shared by the files */
+    if (options.manifest != "") {
+        if (options.checkpoint_file != "") throw runtime_error("-CHECKPOINT: only with a single -FILE");
+        if (options.output_dir == "") throw runtime_error("-OUTPUTDIR: required with -MANIFEST or -DIRECTORY");
+        
+        vector<string> batch_files;
+        if (filesystem::is_directory(options.manifest)) {
+            for (auto entry : filesystem::directory_iterator(options.manifest)) {
+                if (entry.is_regular_file()) batch_files.push_back(entry.path().string());
+            }
+            sort(batch_files.begin(), batch_files.end());
+        } else {
+            ifstream manifest(options.manifest);
+            if (!manifest.is_open()) throw runtime_error("Can not read manifest " + options.manifest);
+            string line;
+            while (getline(manifest, line)) {
+                if (line != "") batch_files.push_back(line);
+            }
+        }
+        filesystem::create_directories(options.output_dir);
+        
+        /* a thread waiting inside a file only helps with the tasks of that file, files never run nested in one another */
+        threadPool* pool = new threadPool(options.num_threads);
+        vector<future<string>> statuses;
+        vector<string> json_records(batch_files.size());
+        for (int i = 0; i < batch_files.size(); i++) {
+            string file = batch_files[i];
+            string* json_record = &json_records[i];
+            statuses.push_back(pool->submit<string>([options, file, pool, json_record]() -> string {
+                auto start = chrono::steady_clock::now();
+                string status;
+                try {
+                    synthesis_options_t file_options = options;
+                    file_options.file_name = file;
+                    parse_file_name(file, &file_options.bench_name, &file_options.ref_id);
+                    exampleTable example_table;
+                    readExampleTable(file, &example_table);
+                    
+                    ostringstream result;
+                    status = (synthesize_and_dump(file_options, &example_table, result, pool) != "") ? "found" : "not_found";
+                    ofstream out(options.output_dir + "/" + filesystem::path(file).filename().string() + ".syn");
+                    out << result.str();
+                    *json_record = result.str();
+                } catch (const exception& e) {
+                    status = string("error ") + e.what();
+                    ostringstream error_record;
+                    dump_error_record({file}, e.what(), error_record);
+                    *json_record = error_record.str();
+                }
+                ostringstream record;
+                record << file << " " << fixed << setprecision(3)
+                       << chrono::duration<double>(chrono::steady_clock::now() - start).count() << " " << status;
+                return record.str();
+            }));
+        }
+        
+        /* per-file status and timing, in the order of the manifest, JSON output keeps stdout to the records */
+        ofstream status_out(options.output_dir + "/batch_status.txt");
+        ostream& info = (options.output_format == "JSON") ? cerr : cout;
+        int num_of_found = 0;
+        for (int i = 0; i < statuses.size(); i++) {
+            string record = pool->wait(statuses[i]);
+            if (record.size() >= 6 && record.compare(record.size() - 6, 6, " found") == 0) num_of_found++;
+            status_out << record << endl;
+            if (options.output_format == "JSON") {
+                cout << json_records[i] << flush;
+            } else {
+                cout << record << endl;
+            }
+        }
+        info << "Batch : " << num_of_found << " / " << batch_files.size() << " files found" << endl;
+        
+        delete pool;
+        return 0;
+    }
     
-#ifdef DEBUG
-    if (rules_to_apply.empty()) {
-        cout << "No mode specific rules specified" << endl;
+    /* tracing pipeline: the problems of a tracer are synthesized on the pool while the next tracer runs */
+    if (!options.tracers.empty()) {
+        if (options.checkpoint_file != "") throw runtime_error("-CHECKPOINT: only with a single -FILE");
+        if (options.output_dir != "") filesystem::create_directories(options.output_dir);
+        
+        ostream& info = (options.output_format == "JSON") ? cerr : cout;
+        threadPool* pool = new threadPool(options.num_threads);
+        vector<future<pair<bool, string>>> results;
+        for (int t = 0; t < options.tracers.size(); t++) {
+            string tracer = options.tracers[t];
+            string bench_name = filesystem::path(tracer).filename().string();
+            string suffix = "_" + options.cache_config + "_stream";
+            if (bench_name.size() > suffix.size() && bench_name.compare(bench_name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                bench_name = bench_name.substr(0, bench_name.size() - suffix.size());
+            }
+            
+            /* every bound vector over the train sizes, the smallest first since accesses are sampled on the first run */
+            ioeBuilder builder(bench_name, options.cache_config, options.trace_sampling_rate, options.trace_max_num_of_sampled, options.sampling_seed);
+            vector<int> train_sizes = options.train_sizes;
+            sort(train_sizes.begin(), train_sizes.end());
+            vector<int> bounds(options.trace_num_of_bounds[t], train_sizes[0]);
+            vector<int> size_ids(bounds.size(), 0);
+            while (true) {
+                builder.trace(tracer, bounds);
+                int d = bounds.size() - 1;
+                while (d >= 0 && size_ids[d] + 1 == train_sizes.size()) {
+                    size_ids[d] = 0;
+                    bounds[d] = train_sizes[0];
+                    d--;
+                }
+                if (d < 0) break;
+                size_ids[d]++;
+                bounds[d] = train_sizes[size_ids[d]];
+            }
+            
+            int num_of_queued = results.size();
+            for (auto problem : builder.take_problems()) {
+                filterNonKeyIOEs(&problem.input_outputs);
+                synthesis_options_t problem_options = options;
+                problem_options.file_name = problem.name;
+                problem_options.bench_name = bench_name;
+                problem_options.ref_id = problem.ref_id;
+                results.push_back(pool->submit<pair<bool, string>>([problem_options, problem, pool]() -> pair<bool, string> {
+                    ostringstream result;
+                    bool is_found = false;
+                    try {
+                        is_found = (synthesize_and_dump(problem_options, problem.input_outputs, result, pool) != "");
+                        if (problem_options.output_dir != "") {
+                            ofstream out(problem_options.output_dir + "/" + problem.name + ".syn");
+                            out << result.str();
+                        }
+                    } catch (const exception& e) {
+                        result.str("");
+                        if (problem_options.output_format == "JSON") {
+                            dump_error_record({problem.name}, e.what(), result);
+                        } else {
+                            result << "Error : " << e.what() << endl;
+                        }
+                    }
+                    if (problem_options.output_format == "JSON") return make_pair(is_found, result.str());
+                    return make_pair(is_found, "File : " + problem.name + "\n" + result.str());
+                }));
+            }
+            info << "Traced : " << bench_name << ", " << results.size() - num_of_queued << " problems queued" << endl;
+        }
+        
+        int num_of_found = 0;
+        for (auto &result : results) {
+            pair<bool, string> found_result = pool->wait(result);
+            if (found_result.first) num_of_found++;
+            cout << found_result.second << flush;
+        }
+        info << "Trace : " << num_of_found << " / " << results.size() << " problems found" << endl;
+        
+        delete pool;
+        return 0;
     }
-    else {
-        cout << "Applying rules: " << endl;
-        for (auto rule : rules_to_apply) {
-            cout << rule << " ";
+    
+    /* parametric: one program per reference, valid at every iteration point of its files */
+    if (!options.parametric_files.empty()) {
+        if (options.checkpoint_file != "") throw runtime_error("-CHECKPOINT: only with a single -FILE");
+        
+        /* examples are filtered per file, the bound grid of every iteration point keeps its key examples */
+        map<int, vector<string>> reference_files;
+        map<int, vector<input_outputs_t>> reference_problems;
+        for (auto file : options.parametric_files) {
+            int ref_id;
+            parse_file_name(file, &options.bench_name, &ref_id);
+            input_outputs_t input_outputs;
+            if (!readInputOutput(file, &input_outputs)) {
+                cout << "Error reading files" << endl;
+                return 0;
+            }
+            reference_files[ref_id].push_back(file);
+            reference_problems[ref_id].push_back(input_outputs);
         }
-        cout << endl;
+        
+        /* the program of a reference is the result of each of its files */
+        if (options.output_dir != "") filesystem::create_directories(options.output_dir);
+        ostream& info = (options.output_format == "JSON") ? cerr : cout;
+        for (auto reference : reference_problems) {
+            input_outputs_t input_outputs;
+            bool is_consistent = merge_problems(reference.second, &input_outputs);
+            info << "Parametric : reference " << reference.first << " over " << reference.second.size() << " files, " << input_outputs.size() << " examples" << endl;
+            ostringstream result;
+            if (!is_consistent) {
+                if (options.output_format == "JSON") {
+                    dump_error_record(reference_files[reference.first], "Files disagree on the output of the same inputs", result);
+                } else {
+                    result << "Files disagree on the output of the same inputs" << endl;
+                    result << "Not yet found, (T^T)" << endl;
+                }
+            } else {
+                synthesis_options_t reference_options = options;
+                reference_options.file_name = reference_files[reference.first][0];
+                reference_options.result_files = reference_files[reference.first];
+                reference_options.ref_id = reference.first;
+                synthesize_and_dump(reference_options, input_outputs, result);
+            }
+            cout << result.str();
+            if (options.output_dir != "") {
+                for (auto file : reference_files[reference.first]) {
+                    ofstream out(options.output_dir + "/" + filesystem::path(file).filename().string() + ".syn");
+                    out << result.str();
+                }
+            }
+        }
+        return 0;
     }
-#endif
+    
+    /* several files: synthesize once per class of equivalent problems and fan the result out */
+    if (!options.files.empty()) {
+        if (options.checkpoint_file != "") throw runtime_error("-CHECKPOINT: only with a single -FILE");
         
+        vector<string> files = options.files;
+        if (options.output_dir != "") filesystem::create_directories(options.output_dir);
+        vector<input_outputs_t> file_input_outputs(files.size());
+        vector<int> file_ref_ids(files.size());
+        vector<string> file_constant_columns(files.size());
+        unordered_map<string, int> problem_ids;
+        vector<vector<int>> problem_files;
+        for (int i = 0; i < files.size(); i++) {
+            if (!readInputOutput(files[i], &file_input_outputs[i])) {
+                cout << "Error reading files" << endl;
+                return 0;
+            }
+            parse_file_name(files[i], &options.bench_name, &file_ref_ids[i]);
+            string canonical_problem = canonicalize_problem(file_ref_ids[i], file_input_outputs[i], &file_constant_columns[i]);
+            auto it = problem_ids.find(canonical_problem);
+            if (it == problem_ids.end()) {
+                problem_ids[canonical_problem] = problem_files.size();
+                problem_files.push_back({i});
+            } else {
+                problem_files[it->second].push_back(i);
+            }
+        }
+        
+        for (auto members : problem_files) {
+            int representative = members[0];
+            input_outputs_t input_outputs = file_input_outputs[representative];
+            
+            /* members differing in constant columns share a program over the other columns only */
+            for (auto member : members) {
+                if (file_constant_columns[member] != file_constant_columns[representative]) {
+                    input_outputs = drop_constant_columns(input_outputs);
+                    break;
+                }
+            }
+            
+            synthesis_options_t problem_options = options;
+            problem_options.file_name = files[representative];
+            problem_options.ref_id = file_ref_ids[representative];
+            for (auto member : members) problem_options.result_files.push_back(files[member]);
+            ostringstream result;
+            synthesize_and_dump(problem_options, input_outputs, result);
+            if (options.output_dir != "") {
+                for (auto member : members) {
+                    ofstream out(options.output_dir + "/" + filesystem::path(files[member]).filename().string() + ".syn");
+                    out << result.str();
+                }
+            }
+            if (options.output_format == "JSON") {
+                cout << result.str();
+                continue;
+            }
+            for (auto member : members) {
+                cout << "File : " << files[member] << endl;
+                cout << result.str();
+            }
+        }
+        ostream& info = (options.output_format == "JSON") ? cerr : cout;
+        info << "Dedup : " << files.size() << " files in " << problem_files.size() << " problems (ratio "
+             << fixed << setprecision(2) << (double)files.size() / problem_files.size() << ")" << endl;
+        return 0;
+    }
+    
     /*
-     language configuration
-    */
-    language_configuration(&depth_bound_for_predicate, &int_ops_for_predicate, &bool_ops_for_predicate, &vars_in_predicate, &constants_in_predicate,
-                      &depth_bound_for_term, &int_ops_for_term, &bool_ops_for_term, &vars_in_term, &constants_in_term,
-                      input_outputs);
-    
-    unification* uni = new unification(depth_bound_for_predicate, int_ops_for_predicate, bool_ops_for_predicate, vars_in_predicate, constants_in_predicate,
-                                       depth_bound_for_term, int_ops_for_term, bool_ops_for_term, vars_in_term, constants_in_term,
-                                       rules_to_apply,
-                                       bench_name, ref_id,
-                                       num_growing_speed, num_growing_upperbound,
-                                       input_outputs);
-#ifdef DEBUG
-    cout << "Search time: terms " << search_time_for_terms_in_seconds << " predications " << search_time_for_predicates_in_seconds << endl;
-    uni->dump_language_defination();
-#endif
-
-    uni->search(search_time_for_terms_in_seconds, search_time_for_predicates_in_seconds);
-
-#ifdef DEBUG
-    uni->dump_searched_program();
-#endif
-
-    //writeSearchedProgram(file_name, uni->getSearchedProgram());
-    uni->dump_searched_program();
+     read input output files
+     */
+    exampleTable example_table;
+    if (!readExampleTable(options.file_name, &example_table)) {
+        cout << "Error reading files" << endl;
+        return 0;
+    }
+    
+    ostringstream result;
+    synthesize_and_dump(options, &example_table, result);
+    cout << result.str();
+    if (options.output_dir != "") {
+        filesystem::create_directories(options.output_dir);
+        ofstream out(options.output_dir + "/" + filesystem::path(options.file_name).filename().string() + ".syn");
+        out << result.str();
+    }
     
     return 0;
 }
@@ -0,0 +1,63 @@
+#include "synthesizer.hpp"
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+/*
+ A batch runs every file as a task of one pool, like -MANIFEST and -DIRECTORY.
+ Three files are solved by a term within a fraction of a second, three have
+ random outputs and use up their budgets. With two workers a thread waiting
+ inside a solvable file must not run an unsolvable one on its stack: the
+ solvable file would run out of budget meanwhile and its time would include
+ the other file.
+ */
+int main() {
+    int search_time_in_seconds = 2;
+    mt19937 generator(3);
+    vector<input_outputs_t> files;
+    for (int k : {0, 2, 3}) {
+        input_outputs_t input_outputs;
+        for (int b0 = 1; b0 <= 8; b0++) {
+            for (int b1 = 1; b1 <= 8; b1++) input_outputs.push_back({{"b0", b0}, {"b1", b1}, {"_out", b0 * b1 + k}});
+        }
+        files.push_back(input_outputs);
+    }
+    for (int k = 0; k < 3; k++) {
+        input_outputs_t input_outputs;
+        for (int b0 = 1; b0 <= 8; b0++) {
+            for (int b1 = 1; b1 <= 8; b1++) input_outputs.push_back({{"b0", b0}, {"b1", b1}, {"_out", (int)(generator() % 1000)}});
+        }
+        files.push_back(input_outputs);
+    }
+    
+    threadPool* pool = new threadPool(2);
+    vector<future<synthesis_result_t>> results;
+    for (int i = 0; i < files.size(); i++) {
+        synthesis_config_t config;
+        config.bench_name = "batch" + to_string(i);
+        config.search_time_for_terms_in_seconds = search_time_in_seconds;
+        config.search_time_for_predicates_in_seconds = search_time_in_seconds;
+        input_outputs_t input_outputs = files[i];
+        results.push_back(pool->submit<synthesis_result_t>([config, input_outputs, pool]() -> synthesis_result_t {
+            return synthesize(config, input_outputs, synthesis_callbacks_t(), nullptr, pool);
+        }));
+    }
+    
+    bool is_passed = true;
+    for (int i = 0; i < results.size(); i++) {
+        synthesis_result_t result = pool->wait(results[i]);
+        bool is_solvable = (i < 3);
+        cout << "File " << i << " : " << (result.is_found ? result.program->to_string() : "not found") << " in " << result.stats.seconds << " seconds" << endl;
+        if (is_solvable && (!result.is_found || result.stats.seconds >= search_time_in_seconds)) {
+            cerr << "File " << i << " was not solved within the term budget" << endl;
+            is_passed = false;
+        }
+        if (!is_solvable && result.is_found) {
+            cerr << "File " << i << " has random outputs but was solved" << endl;
+            is_passed = false;
+        }
+    }
+    delete pool;
+    return is_passed ? 0 : 1;
+}
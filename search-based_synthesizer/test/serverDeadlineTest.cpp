@@ -0,0 +1,97 @@
+#include "synthesisServer.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+/*
+ Two concurrent requests on one server: a slow one with random outputs that
+ runs until its deadline, and a quick one solved by a term within a fraction
+ of a second. Requests share the pool, but the thread of the quick request
+ only helps with its own searches while it waits: its latency must not
+ follow the deadline of the slow request.
+ */
+static string request(const string& socket_path, const string& payload) {
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    socket_path.copy(address.sun_path, socket_path.size());
+    if (connection < 0 || connect(connection, (sockaddr*)&address, sizeof(address)) < 0) return "";
+    
+    string frame = to_string(payload.size()) + "\n" + payload;
+    if (write(connection, frame.data(), frame.size()) != (ssize_t)frame.size()) {
+        close(connection);
+        return "";
+    }
+    string response;
+    char buffer[4096];
+    ssize_t num_of_bytes;
+    while ((num_of_bytes = read(connection, buffer, sizeof(buffer))) > 0) {
+        response.append(buffer, num_of_bytes);
+        size_t header_end = response.find('\n');
+        if (header_end != string::npos && response.size() - header_end - 1 >= stoul(response.substr(0, header_end))) break;
+    }
+    close(connection);
+    return response;
+}
+
+int main() {
+    int deadline_in_seconds = 2;
+    string socket_path = "/tmp/serverDeadlineTest_" + to_string(getpid()) + ".sock";
+    
+    synthesis_config_t config;
+    config.num_threads = 2;
+    request_parser_t request_parser = [](const string& request_options, synthesis_config_t* config) {
+        istringstream options(request_options);
+        string option;
+        while (options >> option) {
+            if (option == "-DEADLINE") options >> config->deadline_in_seconds;
+        }
+    };
+    synthesisServer* server = new synthesisServer(socket_path, config, request_parser, 4);
+    thread serving([server]() { server->serve(); });
+    
+    mt19937 generator(3);
+    string slow_examples, quick_examples;
+    for (int b0 = 1; b0 <= 8; b0++) {
+        for (int b1 = 1; b1 <= 8; b1++) {
+            slow_examples += "b0 " + to_string(b0) + " b1 " + to_string(b1) + " _out " + to_string(generator() % 1000) + "\n";
+            quick_examples += "b0 " + to_string(b0) + " b1 " + to_string(b1) + " _out " + to_string(b0 * b1 + 2) + "\n";
+        }
+    }
+    
+    auto start = chrono::steady_clock::now();
+    string slow_response;
+    double slow_seconds = 0;
+    thread slow_client([&]() {
+        slow_response = request(socket_path, "-DEADLINE " + to_string(deadline_in_seconds) + "\n" + slow_examples);
+        slow_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    });
+    this_thread::sleep_for(chrono::milliseconds(300));
+    auto quick_start = chrono::steady_clock::now();
+    string quick_response = request(socket_path, "-DEADLINE 20\n" + quick_examples);
+    double quick_seconds = chrono::duration<double>(chrono::steady_clock::now() - quick_start).count();
+    slow_client.join();
+    
+    server->stop();
+    serving.join();
+    delete server;
+    
+    cout << "Quick request in " << quick_seconds << " seconds : " << quick_response;
+    cout << "Slow request in " << slow_seconds << " seconds : " << slow_response;
+    
+    bool is_passed = true;
+    if (quick_response.find("Searched Program") == string::npos || quick_seconds >= deadline_in_seconds / 2.0) {
+        cerr << "The quick request was not answered ahead of the slow one" << endl;
+        is_passed = false;
+    }
+    if (slow_response.find("Not yet found") == string::npos || slow_seconds >= deadline_in_seconds + 1) {
+        cerr << "The slow request did not stop at its deadline" << endl;
+        is_passed = false;
+    }
+    return is_passed ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+#include "synthesizer.hpp"
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+/*
+ The term search wins while a speculative split mode is still running.
+ With two workers the thread waiting on the root runs one of the split modes
+ inline, its predicate search can not separate the halves of the examples and
+ would run for its whole budget. The term search finds its program in well
+ under a second and has to stop that split mode.
+ */
+int main() {
+    mt19937 generator(1);
+    input_outputs_t input_outputs;
+    for (int i = 0; i < 40; i++) {
+        int b0 = generator() % 30 + 1;
+        int b1 = generator() % 30 + 1;
+        input_outputs.push_back({{"b0", b0}, {"b1", b1}, {"_out", b0 * b1 + 2 * b0 + 3}});
+    }
+    
+    synthesis_config_t config;
+    config.num_threads = 2;
+    config.search_time_for_terms_in_seconds = 60;
+    config.search_time_for_predicates_in_seconds = 60;
+    config.language.depth_bound_for_predicate = 12;
+    config.num_growing_upperbound = 1000;
+    config.split_strategies = {"HALF"};
+    
+    synthesis_result_t result = synthesize(config, input_outputs);
+    if (!result.is_found) {
+        cerr << "No program found" << endl;
+        return 1;
+    }
+    cout << "Searched Program : " << result.program->to_string() << " in " << result.stats.seconds << " seconds" << endl;
+    
+    /* far below the predicate budget the split mode would run for */
+    if (result.stats.seconds > 20) {
+        cerr << "The split mode was not stopped by the term search" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -18,7 +18,7 @@ def get_failed_ioe_with_no_sym_ri(cache_config, benches, ioe_path, sym_ri_path):
                 if (mode in sym_ri_file):
                     f = open(sym_ri_path + bench + "/" + sym_ri_file)
                     first_line = f.readline()
-                    if ("(^0^)" not in first_line):
+                    if ("(^0^)" not in first_line and '"found":true' not in first_line):
                         failed_ioe_files.append(sym_ri_file)
             failed_ioes[mode][bench] = failed_ioe_files
             print bench, len(ioe_files), len(failed_ioe_files),